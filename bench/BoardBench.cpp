@@ -0,0 +1,296 @@
+//Microbenchmarks for Board operations on sizes from 9x9 up to 10000x10000.
+//Prints one JSON record per line so runs can be diffed or compared with --baseline.
+//  board_bench [--max-cells N] [--out results.json] [--baseline previous.json]
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include "Board.h"
+#include "BoardSnapshot.h"
+#include "SharedBoard.h"
+#include "ThreadPool.h"
+#include "Random.h"
+
+//Every allocation in the process goes through here so each benchmark can report allocations per op
+static std::atomic<long long> g_allocs(0);
+static std::atomic<long long> g_allocBytes(0);
+
+void* operator new(std::size_t size)
+{
+	g_allocs.fetch_add(1, std::memory_order_relaxed);
+	g_allocBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+struct BenchResult {
+	std::string op;
+	int width;
+	int height;
+	int mines;
+	long long iterations;
+	double nsPerOp;
+	double cellsPerSec;
+	double allocsPerOp;
+	double bytesPerOp;
+
+	std::string id() const {
+		return op + "/" + std::to_string(width) + "x" + std::to_string(height) + "/" + std::to_string(mines);
+	}
+};
+
+//Work done by one timed call: how many operations and how many cells they touched
+struct Work {
+	long long ops;
+	long long cells;
+};
+
+static std::vector<BenchResult> g_results;
+
+//Repeats setup (untimed) + body (timed) until about 0.2 s of body time or 2 s of wall time have passed
+template <class Setup, class Body>
+static void measure(const char* op, const Board& board, Setup setup, Body body)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto wallStart = Clock::now();
+	double ns = 0.0;
+	long long ops = 0, cells = 0, allocs = 0, bytes = 0, iterations = 0;
+	while (iterations == 0 || (ns < 2e8 && Clock::now() - wallStart < std::chrono::seconds(2))) {
+		setup();
+		const long long allocsBefore = g_allocs.load();
+		const long long bytesBefore = g_allocBytes.load();
+		const auto start = Clock::now();
+		Work work = body();
+		ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+		allocs += g_allocs.load() - allocsBefore;
+		bytes += g_allocBytes.load() - bytesBefore;
+		ops += work.ops;
+		cells += work.cells;
+		++iterations;
+	}
+	ops = ops > 0 ? ops : 1;
+	g_results.push_back({ op, board.getWidth(), board.getHeight(), board.getMineCount(), ops, ns / ops,
+		ns > 0.0 ? cells / (ns * 1e-9) : 0.0, static_cast<double>(allocs) / ops, static_cast<double>(bytes) / ops });
+	const BenchResult& r = g_results.back();
+	std::cerr << std::left << std::setw(34) << r.id() << std::right << std::fixed << std::setprecision(1)
+		<< std::setw(14) << r.nsPerOp << " ns/op" << std::setw(16) << std::setprecision(0) << r.cellsPerSec
+		<< " cells/s" << std::setw(10) << std::setprecision(2) << r.allocsPerOp << " allocs/op\n";
+}
+
+//Flags every mine so chords around revealed numbers are always allowed
+static void flagAllMines(Board& board)
+{
+	for (int y = 0; y < board.getHeight(); ++y) {
+		for (int x = 0; x < board.getWidth(); ++x) {
+			if (board.getCell(x, y).isMine) board.toggleFlag(x, y);
+		}
+	}
+}
+
+static void benchSize(int width, int height)
+{
+	const long long cells = static_cast<long long>(width) * height;
+	uint64_t seed = 1;
+	Random rng(width * 131 + height);
+
+	{
+		//Expert-like density takes the per-mine incremental count path
+		Board board(width, height, static_cast<int>(cells * 0.15), 0);
+		measure("generate", board, [&] { board.resetBoard(seed++); },
+			[&] { board.generate(width / 2, height / 2); return Work{ 1, cells }; });
+
+		//Toggling random hidden cells on a fresh board
+		std::vector<std::pair<int, int>> targets(4096);
+		for (auto& t : targets) t = { static_cast<int>(rng.below(width)), static_cast<int>(rng.below(height)) };
+		measure("toggleFlag", board, [&] { board.resetBoard(seed++); }, [&] {
+			for (const auto& t : targets) board.toggleFlag(t.first, t.second);
+			return Work{ static_cast<long long>(targets.size()), static_cast<long long>(targets.size()) };
+		});
+
+		//Chording revealed numbers whose mines are all flagged; each chord opens its hidden neighbours
+		std::vector<std::pair<int, int>> numbers;
+		measure("chordCell", board, [&] {
+			board.resetBoard(seed++);
+			board.generate(width / 2, height / 2);
+			flagAllMines(board);
+			numbers.clear();
+			for (int i = 0; i < 64 * 64 && static_cast<int>(numbers.size()) < 1024; ++i) {
+				int x = static_cast<int>(rng.below(width));
+				int y = static_cast<int>(rng.below(height));
+				Cell c = board.getCell(x, y);
+				if (c.isMine || c.isRevealed || c.adjacentMines == 0) continue;
+				board.revealCell(x, y);
+				numbers.push_back({ x, y });
+			}
+		}, [&] {
+			const int before = board.getCellsRevealed();
+			for (const auto& n : numbers) board.chordCell(n.first, n.second);
+			return Work{ static_cast<long long>(numbers.size()), static_cast<long long>(board.getCellsRevealed() - before) };
+		});
+
+		measure("resetBoard", board, [&] {
+			board.generate(width / 2, height / 2);
+			board.revealCell(width / 2, height / 2);
+		}, [&] { board.resetBoard(seed++); return Work{ 1, cells }; });
+
+		//Swapping in a layout the background thread finished while the game was played
+		board.setPrefetch(true);
+		measure("resetPrefetched", board, [&] {
+			board.generate(width / 2, height / 2);
+			board.revealCell(width / 2, height / 2);
+			while (!board.isPrefetchReady()) std::this_thread::yield();
+		}, [&] { board.resetBoard(); return Work{ 1, cells }; });
+
+		//Time to playable: the swap plus the first click, which must not wait for the next background layout
+		measure("resetAndReveal", board, [&] {
+			board.generate(width / 2, height / 2);
+			while (!board.isPrefetchReady()) std::this_thread::yield();
+		}, [&] {
+			board.resetBoard();
+			board.revealCell(width / 2, height / 2);
+			return Work{ 1, cells };
+		});
+		board.setPrefetch(false);
+
+		//Snapshot round trip through a file in the working directory (page cache, so this times the format)
+		const char* path = "board_bench.sav";
+		board.resetBoard(seed++);
+		board.revealCell(width / 2, height / 2);
+		measure("snapshotSave", board, [] {}, [&] {
+			BoardSnapshot::save(path, board, SnapshotInfo());
+			return Work{ 1, cells };
+		});
+		measure("snapshotLoad", board, [] {}, [&] {
+			BoardSnapshot snapshot(path);
+			snapshot.restore(board);
+			return Work{ 1, cells };
+		});
+		std::remove(path);
+	}
+	{
+		//Half the board mined takes the vectorized rescan path
+		Board board(width, height, static_cast<int>(cells / 2), 0);
+		measure("generate", board, [&] { board.resetBoard(seed++); },
+			[&] { board.generate(width / 2, height / 2); return Work{ 1, cells }; });
+	}
+	{
+		//Sparse mines give huge openings, so this times the flood fill itself
+		Board board(width, height, static_cast<int>(cells / 100), 0);
+		measure("revealCell", board, [&] {
+			board.resetBoard(seed++);
+			board.generate(width / 2, height / 2);
+		}, [&] {
+			board.revealCell(width / 2, height / 2);
+			return Work{ 1, static_cast<long long>(board.getCellsRevealed()) };
+		});
+
+		//The same openings revealed from labels made at generation (labeling itself is untimed here)
+		board.setOpeningLabels(true);
+		measure("revealLabeled", board, [&] {
+			board.resetBoard(seed++);
+			board.generate(width / 2, height / 2);
+		}, [&] {
+			board.revealCell(width / 2, height / 2);
+			return Work{ 1, static_cast<long long>(board.getCellsRevealed()) };
+		});
+		board.setOpeningLabels(false);
+
+		//Every core floods the same board from its own share of safe clicks; the floods meet and merge
+		ThreadPool pool;
+		std::unique_ptr<SharedBoard> shared;
+		std::vector<std::pair<int, int>> clicks;
+		measure("sharedReveal", board, [&] {
+			board.resetBoard(seed++);
+			board.generate(width / 2, height / 2);
+			shared.reset(new SharedBoard(board));
+			clicks.clear();
+			while (clicks.size() < 64) {
+				const int x = static_cast<int>(rng.below(width));
+				const int y = static_cast<int>(rng.below(height));
+				if (!board.getCell(x, y).isMine) clicks.push_back({ x, y });
+			}
+		}, [&] {
+			pool.parallelFor(static_cast<int>(clicks.size()), [&](int i) { shared->revealCell(clicks[i].first, clicks[i].second); });
+			return Work{ 1, static_cast<long long>(shared->getCellsRevealed()) };
+		});
+	}
+}
+
+static std::string toJson(const BenchResult& r)
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3);
+	out << "{\"id\": \"" << r.id() << "\", \"op\": \"" << r.op << "\", \"width\": " << r.width
+		<< ", \"height\": " << r.height << ", \"mines\": " << r.mines << ", \"iterations\": " << r.iterations
+		<< ", \"ns_per_op\": " << r.nsPerOp << ", \"cells_per_sec\": " << r.cellsPerSec
+		<< ", \"allocs_per_op\": " << r.allocsPerOp << ", \"bytes_per_op\": " << r.bytesPerOp << "}";
+	return out.str();
+}
+
+//Reads id -> ns_per_op from a file written by this tool (one record per line)
+static std::map<std::string, double> readBaseline(const char* path)
+{
+	std::map<std::string, double> baseline;
+	std::ifstream in(path);
+	std::string line;
+	while (std::getline(in, line)) {
+		size_t id = line.find("\"id\": \"");
+		size_t ns = line.find("\"ns_per_op\": ");
+		if (id == std::string::npos || ns == std::string::npos) continue;
+		id += 7;
+		baseline[line.substr(id, line.find('"', id) - id)] = std::atof(line.c_str() + ns + 13);
+	}
+	return baseline;
+}
+
+int main(int argc, char** argv)
+{
+	long long maxCells = 10000LL * 10000LL;
+	const char* outPath = nullptr;
+	const char* baselinePath = nullptr;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!std::strcmp(argv[i], "--max-cells")) maxCells = std::atoll(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--out")) outPath = argv[i + 1];
+		else if (!std::strcmp(argv[i], "--baseline")) baselinePath = argv[i + 1];
+	}
+
+	const int sizes[][2] = { { 9, 9 }, { 30, 16 }, { 100, 100 }, { 1000, 1000 }, { 10000, 10000 } };
+	for (const auto& size : sizes) {
+		if (static_cast<long long>(size[0]) * size[1] > maxCells) break;
+		benchSize(size[0], size[1]);
+	}
+
+	std::ostringstream json;
+	json << "{\"benchmarks\": [\n";
+	for (size_t i = 0; i < g_results.size(); ++i) {
+		json << "  " << toJson(g_results[i]) << (i + 1 < g_results.size() ? ",\n" : "\n");
+	}
+	json << "]}\n";
+	if (outPath) std::ofstream(outPath) << json.str();
+	else std::cout << json.str();
+
+	if (baselinePath) {
+		std::map<std::string, double> baseline = readBaseline(baselinePath);
+		std::cerr << "\nvs " << baselinePath << " (ratio < 1 is faster)\n";
+		for (const BenchResult& r : g_results) {
+			auto found = baseline.find(r.id());
+			if (found == baseline.end() || found->second <= 0.0) continue;
+			std::cerr << std::left << std::setw(34) << r.id() << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(8) << r.nsPerOp / found->second << "x\n";
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,155 @@
+#include "ActionLog.h"
+#include <cstdio>
+#include <cstring>
+
+static const char actionLogMagic[8] = { 'M', 'S', 'W', 'P', 'L', 'O', 'G', '\0' };
+static const uint32_t actionLogVersion = 1;
+static const int typeBits = 3; //Width of the action type field in the first varint
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+	while (value >= 0x80) {
+		out.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool getVarint(const std::vector<uint8_t>& in, size_t& offset, uint64_t& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64 && offset < in.size(); shift += 7) {
+		const uint8_t byte = in[offset++];
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) return true;
+	}
+	return false;
+}
+
+//Small deltas of either sign become small unsigned values: 0, -1, 1, -2 ... -> 0, 1, 2, 3 ...
+static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+ActionLog::ActionLog() : width(0), height(0), mineCount(0), seed(0), safeRadius(1)
+{
+	startTime = std::chrono::steady_clock::now();
+}
+
+void ActionLog::start(int width, int height, int mineCount, uint64_t seed, int safeRadius)
+{
+	this->width = width;
+	this->height = height;
+	this->mineCount = mineCount;
+	this->seed = seed;
+	this->safeRadius = safeRadius;
+	bytes.clear();
+	tail = Cursor();
+	startTime = std::chrono::steady_clock::now();
+}
+
+void ActionLog::record(ActionType type, int x, int y)
+{
+	const auto elapsed = std::chrono::steady_clock::now() - startTime;
+	record(type, x, y, static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+}
+
+void ActionLog::record(ActionType type)
+{
+	record(type, tail.x, tail.y);
+}
+
+void ActionLog::record(ActionType type, int x, int y, uint32_t timeMs)
+{
+	//Clocks only move forward; a timestamp from the past is stored as "no time passed"
+	const uint32_t delta = timeMs > tail.timeMs ? timeMs - tail.timeMs : 0;
+	putVarint(bytes, (zigzag(static_cast<int64_t>(x) - tail.x) << typeBits) | type);
+	putVarint(bytes, zigzag(static_cast<int64_t>(y) - tail.y));
+	putVarint(bytes, delta);
+	tail.offset = bytes.size();
+	tail.index++;
+	tail.x = x;
+	tail.y = y;
+	tail.timeMs += delta;
+}
+
+bool ActionLog::next(Cursor& cursor, Action& action) const
+{
+	size_t offset = cursor.offset;
+	uint64_t first, second, delta;
+	if (!getVarint(bytes, offset, first) || !getVarint(bytes, offset, second) || !getVarint(bytes, offset, delta)) {
+		return false;
+	}
+	cursor.offset = offset;
+	cursor.index++;
+	cursor.x += static_cast<int>(unzigzag(first >> typeBits));
+	cursor.y += static_cast<int>(unzigzag(second));
+	cursor.timeMs += static_cast<uint32_t>(delta);
+
+	action.type = static_cast<ActionType>(first & ((1u << typeBits) - 1));
+	action.x = cursor.x;
+	action.y = cursor.y;
+	action.timeMs = cursor.timeMs;
+	return true;
+}
+
+size_t ActionLog::size() const { return tail.index; }
+size_t ActionLog::byteSize() const { return bytes.size(); }
+uint32_t ActionLog::getDurationMs() const { return tail.timeMs; }
+int ActionLog::getWidth() const { return width; }
+int ActionLog::getHeight() const { return height; }
+int ActionLog::getMineCount() const { return mineCount; }
+uint64_t ActionLog::getSeed() const { return seed; }
+int ActionLog::getSafeRadius() const { return safeRadius; }
+
+//File layout: magic, version, the game header, then the encoded actions
+bool ActionLog::save(const std::string& path) const
+{
+	FILE* file = std::fopen(path.c_str(), "wb");
+	if (!file) return false;
+	const int32_t fields[4] = { width, height, mineCount, safeRadius };
+	const uint64_t counts[2] = { static_cast<uint64_t>(tail.index), static_cast<uint64_t>(bytes.size()) };
+	bool ok = std::fwrite(actionLogMagic, sizeof(actionLogMagic), 1, file) == 1;
+	ok = ok && std::fwrite(&actionLogVersion, sizeof(actionLogVersion), 1, file) == 1;
+	ok = ok && std::fwrite(fields, sizeof(fields), 1, file) == 1;
+	ok = ok && std::fwrite(&seed, sizeof(seed), 1, file) == 1;
+	ok = ok && std::fwrite(counts, sizeof(counts), 1, file) == 1;
+	ok = ok && (bytes.empty() || std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size());
+	ok = std::fclose(file) == 0 && ok;
+	return ok;
+}
+
+bool ActionLog::load(const std::string& path)
+{
+	FILE* file = std::fopen(path.c_str(), "rb");
+	if (!file) return false;
+	char magic[8];
+	uint32_t version = 0;
+	int32_t fields[4];
+	uint64_t fileSeed = 0;
+	uint64_t counts[2];
+	bool ok = std::fread(magic, sizeof(magic), 1, file) == 1 && std::memcmp(magic, actionLogMagic, sizeof(magic)) == 0;
+	ok = ok && std::fread(&version, sizeof(version), 1, file) == 1 && version == actionLogVersion;
+	ok = ok && std::fread(fields, sizeof(fields), 1, file) == 1;
+	ok = ok && std::fread(&fileSeed, sizeof(fileSeed), 1, file) == 1;
+	ok = ok && std::fread(counts, sizeof(counts), 1, file) == 1;
+	std::vector<uint8_t> data;
+	if (ok) {
+		data.resize(static_cast<size_t>(counts[1]));
+		ok = data.empty() || std::fread(data.data(), 1, data.size(), file) == data.size();
+	}
+	std::fclose(file);
+	if (!ok) return false;
+
+	//Decode once to rebuild the tail and reject truncated logs
+	start(fields[0], fields[1], fields[2], fileSeed, fields[3]);
+	bytes.swap(data);
+	Action action;
+	while (next(tail, action)) {}
+	if (tail.index != counts[0] || tail.offset != bytes.size()) {
+		start(fields[0], fields[1], fields[2], fileSeed, fields[3]);
+		return false;
+	}
+	return true;
+}
+
+//End of ActionLog.cpp
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef ACTIONLOG_H
+#define ACTIONLOG_H
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+enum ActionType : uint8_t {
+	ACTION_REVEAL,
+	ACTION_FLAG,
+	ACTION_CHORD,
+	ACTION_UNDO, //Only recorded when Board::undo/redo changed something
+	ACTION_REDO
+};
+
+struct Action {
+	ActionType type;
+	int x;
+	int y;
+	uint32_t timeMs; //Since the log was started
+};
+
+//Compact record of every move made on one game, tied to the board's size and seed so the game can be
+//rebuilt exactly. Each action is three varints: the cell as a zigzag delta from the previous action
+//(with the type in the low 3 bits of x), then the milliseconds since the previous action.
+//Typical play costs three to four bytes per action.
+class ActionLog {
+	public:
+		//Decoding position; start from a default Cursor and pass it to next() repeatedly
+		struct Cursor {
+			size_t offset;
+			size_t index;
+			int x;
+			int y;
+			uint32_t timeMs;
+
+			Cursor() : offset(0), index(0), x(0), y(0), timeMs(0) {}
+		};
+
+		ActionLog();
+
+		//Clears the log for a new game; the clock restarts at zero
+		void start(int width, int height, int mineCount, uint64_t seed, int safeRadius);
+		void record(ActionType type, int x, int y); //Stamped with the time since start
+		void record(ActionType type, int x, int y, uint32_t timeMs);
+		void record(ActionType type); //For undo/redo: reuses the previous cell, so the deltas are zero
+
+		//Decodes the action at cursor and moves past it; false at the end of the log
+		bool next(Cursor& cursor, Action& action) const;
+
+		size_t size() const;
+		size_t byteSize() const;
+		uint32_t getDurationMs() const; //Timestamp of the last action
+		int getWidth() const;
+		int getHeight() const;
+		int getMineCount() const;
+		uint64_t getSeed() const;
+		int getSafeRadius() const;
+
+		bool save(const std::string& path) const;
+		bool load(const std::string& path);
+
+	private:
+		int width;
+		int height;
+		int mineCount;
+		uint64_t seed;
+		int safeRadius;
+
+		std::vector<uint8_t> bytes;
+		Cursor tail; //State after the last recorded action, so record() can encode the next delta
+		std::chrono::steady_clock::time_point startTime;
+};
+
+#endif
@@ -1,11 +1,31 @@
 #include "Board.h"
-#include <cstdlib>
-#include <ctime>
+#include "Random.h"
+#include "ActionLog.h"
+#include "UnionFind.h"
 #include <algorithm>
 #include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <bitset>
+#include <cstring>
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BOARD_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BOARD_SIMD_SSE2
+#endif
 
 //Constructor to initialize the board with given dimensions and mine count
-Board::Board(int width, int height, int mineCount)
+Board::Board(int width, int height, int mineCount) : Board(width, height, mineCount, makeSeed())
+{
+}
+
+//Constructor for a reproducible board: the same seed and first click always give the same layout
+Board::Board(int width, int height, int mineCount, uint64_t seed)
 {
 	//Set board dimensions and mine count
 	this->width = width;
@@ -16,65 +36,224 @@ Board::Board(int width, int height, int mineCount)
 	this->isGameWon = false;
 	this->cellsRevealed = 0;
 	this->flagsPlaced = 0; // initialize flagsPlaced to avoid undefined behavior
+	this->seed = seed;
+	this->safeRadius = 1;
+	this->recorder = nullptr;
+	this->journalBase = 0;
+	this->journalCursor = 0;
+	this->undoDepth = 0;
+	this->undoMaxCells = 0;
+
+	//Initialize the board with empty cells plus the sentinel border
+	this->stride = width + 2;
+	cells.resize(static_cast<size_t>(stride) * (height + 2));
+	const int offsets[8] = {
+		-stride - 1, -stride, -stride + 1,
+		-1,                    1,
+		stride - 1,  stride,  stride + 1
+	};
+	std::copy(offsets, offsets + 8, neighbourOffsets);
 
-	//Initialize the board with empty cells
-	cell.resize(height, std::vector<Cell>(width));
+	//At least one cell must stay free for the first click
+	this->mineCount = std::max(0, std::min(mineCount, width * height - 1));
+	this->prefetchEnabled = false;
+	this->trackFrontier = false;
+	this->labelOpenings = false;
+	this->openingsReady = false;
+	this->nextSeed = 0;
+	this->nextMineCount = 0;
+	layOut(cells, seed, this->mineCount);
+	this->layoutReady = true;
+}
 
-	// Seed RNG once (avoid reseeding every time placeMines is called).
-	std::srand(static_cast<unsigned int>(std::time(nullptr)));
+Board::~Board()
+{
+	waitPrefetch();
 }
 
-//Places mines in random coordinates of the board
-void Board::placeMines(int ClickX, int ClickY) {
-	int placedMines = 0;
-	while (placedMines < mineCount) {
-		int x = std::rand() % width;
-		int y = std::rand() % height;
-		//Avoid placing mine on the first clicked cell and sees if cell does not already contain a mine
-		if ((x != ClickX || y != ClickY) && !cell[y][x].isMine) {
-			cell[y][x].isMine = true;
-			placedMines++;
+//Fresh seed for unseeded boards; the counter keeps boards created in the same instant distinct
+uint64_t Board::makeSeed()
+{
+	static std::atomic<uint64_t> counter(0);
+	uint64_t entropy = static_cast<uint64_t>(std::random_device{}()) << 32;
+	entropy ^= static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+	return entropy ^ (counter.fetch_add(1) * 0x9E3779B97F4A7C15ull);
+}
+
+//Clears every cell and marks the outer ring as revealed border so floods and chords stop there
+void Board::clearCells(std::vector<uint8_t>& buffer) const
+{
+	std::fill(buffer.begin(), buffer.end(), static_cast<uint8_t>(0));
+	markBorder(buffer);
+}
+
+//Placing mines bumps the counts of border bytes too, so a ring that outlives its layout has to be rewritten
+void Board::markBorder(std::vector<uint8_t>& buffer) const
+{
+	const uint8_t border = CELL_BORDER | CELL_REVEALED;
+	std::fill(buffer.begin(), buffer.begin() + stride, border);
+	std::fill(buffer.end() - stride, buffer.end(), border);
+	for (int y = 0; y < height; ++y) {
+		buffer[(y + 1) * stride] = border;
+		buffer[(y + 1) * stride + width + 1] = border;
+	}
+}
+
+//A fresh buffer holding the layout of layoutSeed. Touches only buffer, so it can run on the prefetch thread.
+void Board::layOut(std::vector<uint8_t>& buffer, uint64_t layoutSeed, int mines) const
+{
+	buffer.resize(static_cast<size_t>(stride) * (height + 2));
+	clearCells(buffer);
+	placeMines(buffer, layoutSeed, mines);
+}
+
+//Places mines on random cells of a buffer that has none yet; other bits (flags) are kept.
+//Uses Floyd's sampling over every cell, so it runs in O(mines) at any density.
+void Board::placeMines(std::vector<uint8_t>& buffer, uint64_t layoutSeed, int mines) const {
+	const int totalCells = width * height;
+	auto cellAtRank = [&](int rank) { return cellIndex(rank % width, rank / width); };
+
+	//Dense boards are cheaper to rescan with the vector kernel than to update mine by mine
+	const bool incremental = mines <= totalCells / 4;
+
+	Random rng(layoutSeed);
+	for (int j = totalCells - mines; j < totalCells; ++j) {
+		int index = cellAtRank(static_cast<int>(rng.below(static_cast<uint32_t>(j) + 1)));
+		if (buffer[index] & CELL_MINE) index = cellAtRank(j);
+		buffer[index] |= CELL_MINE;
+		if (incremental) {
+			for (int off : neighbourOffsets) ++buffer[index + off];
 		}
 	}
-    calculateAdjacentMines();
+	if (!incremental) calculateAdjacentMines(buffer);
 }
 
-//Calculates the number of adjacent mines for each cell
-void Board::calculateAdjacentMines()
+//Moves every mine inside the safe zone around the first click to a random free cell outside it.
+//Falls back to clearing only the clicked cell when the board is too dense for the full zone.
+void Board::clearSafeZone(int ClickX, int ClickY) {
+	const int totalCells = width * height;
+	int radius = std::max(safeRadius, 0);
+	const int zoneWidth = std::min(ClickX + radius, width - 1) - std::max(ClickX - radius, 0) + 1;
+	const int zoneHeight = std::min(ClickY + radius, height - 1) - std::max(ClickY - radius, 0) + 1;
+	if (mineCount > totalCells - zoneWidth * zoneHeight) radius = 0;
+	auto inZone = [&](int x, int y) { return std::abs(x - ClickX) <= radius && std::abs(y - ClickY) <= radius; };
+
+	std::vector<int>& moved = movedMines; //Member buffer, so regeneration does not allocate
+	moved.clear();
+	for (int y = std::max(ClickY - radius, 0); y <= std::min(ClickY + radius, height - 1); ++y) {
+		for (int x = std::max(ClickX - radius, 0); x <= std::min(ClickX + radius, width - 1); ++x) {
+			const int index = cellIndex(x, y);
+			if (cells[index] & CELL_MINE) {
+				removeMine(index);
+				moved.push_back(index);
+			}
+		}
+	}
+
+	//Random probes find a free cell quickly unless the board is nearly full; then scan from a random cell
+	Random rng(hashSeed(seed, static_cast<uint64_t>(ClickY) * width + ClickX, 1));
+	for (size_t i = 0; i < moved.size(); ++i) {
+		int rank = static_cast<int>(rng.below(static_cast<uint32_t>(totalCells)));
+		for (int probe = 0; probe < 64 + totalCells; ++probe) {
+			const int x = rank % width;
+			const int y = rank / width;
+			if (!(cells[cellIndex(x, y)] & CELL_MINE) && !inZone(x, y)) break;
+			rank = probe < 64 ? static_cast<int>(rng.below(static_cast<uint32_t>(totalCells))) : (rank + 1) % totalCells;
+		}
+		addMine(cellIndex(rank % width, rank / width));
+	}
+}
+
+//Never waits for the prefetch task: it only writes nextCells, and waiting here would put the next board's
+//layout time back on the first click
+void Board::generate(int firstX, int firstY) {
+	if (firstClickHandled) {
+		clearCells(cells);
+		frontierClear();
+	}
+	if (firstClickHandled || !layoutReady) placeMines(cells, seed, mineCount);
+	clearSafeZone(firstX, firstY);
+	layoutReady = false;
+	firstClickHandled = true;
+	labelOpeningRegions();
+}
+
+//Sets a mine and bumps the counts around it. Border neighbours are skipped: a rescanned layout leaves their
+//counts at zero, and decrementing one would borrow into its mine and revealed bits.
+void Board::addMine(int index) {
+	cells[index] |= CELL_MINE;
+	for (int off : neighbourOffsets) {
+		uint8_t& next = cells[index + off];
+		if (!(next & CELL_BORDER)) ++next;
+	}
+}
+
+void Board::removeMine(int index) {
+	cells[index] &= static_cast<uint8_t>(~CELL_MINE);
+	for (int off : neighbourOffsets) {
+		uint8_t& next = cells[index + off];
+		if (!(next & CELL_BORDER)) --next;
+	}
+}
+
+//Writes the adjacent mine count of row[0..width) into its low nibble.
+//above/row/below point at x = 0 of three consecutive padded rows, so index -1 and width are border cells.
+//The vector paths add the mine masks of the eight shifted neighbour rows, 16 (SSE2) or 32 (AVX2) cells at a time.
+static void countRowMines(const uint8_t* above, uint8_t* row, const uint8_t* below, int width)
 {
-	//Directions for the 8 neighboring cells
-	const int directions[8][2] = {
-		{-1, -1}, {-1, 0}, {-1, 1},
-		{0, -1},          {0, 1},
-		{1, -1}, {1, 0}, {1, 1}
-	};
+	int x = 0;
+#if defined(BOARD_SIMD_AVX2)
+	const __m256i mine = _mm256_set1_epi8(static_cast<char>(CELL_MINE));
+	const __m256i keep = _mm256_set1_epi8(static_cast<char>(~CELL_COUNT));
+	for (; x + 32 <= width; x += 32) {
+		//cmpeq yields -1 per mine, so subtracting the masks adds one per neighbouring mine
+		__m256i count = _mm256_setzero_si256();
+		const uint8_t* src[8] = { above + x - 1, above + x, above + x + 1, row + x - 1,
+			row + x + 1, below + x - 1, below + x, below + x + 1 };
+		for (const uint8_t* p : src) {
+			__m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), mine);
+			count = _mm256_sub_epi8(count, _mm256_cmpeq_epi8(v, mine));
+		}
+		__m256i* dst = reinterpret_cast<__m256i*>(row + x);
+		_mm256_storeu_si256(dst, _mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256(dst), keep), count));
+	}
+#elif defined(BOARD_SIMD_SSE2)
+	const __m128i mine = _mm_set1_epi8(static_cast<char>(CELL_MINE));
+	const __m128i keep = _mm_set1_epi8(static_cast<char>(~CELL_COUNT));
+	for (; x + 16 <= width; x += 16) {
+		//cmpeq yields -1 per mine, so subtracting the masks adds one per neighbouring mine
+		__m128i count = _mm_setzero_si128();
+		const uint8_t* src[8] = { above + x - 1, above + x, above + x + 1, row + x - 1,
+			row + x + 1, below + x - 1, below + x, below + x + 1 };
+		for (const uint8_t* p : src) {
+			__m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), mine);
+			count = _mm_sub_epi8(count, _mm_cmpeq_epi8(v, mine));
+		}
+		__m128i* dst = reinterpret_cast<__m128i*>(row + x);
+		_mm_storeu_si128(dst, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(dst), keep), count));
+	}
+#endif
+	//Scalar tail (and fallback when no vector unit is available)
+	for (; x < width; ++x) {
+		int count = 0;
+		for (int dx = -1; dx <= 1; ++dx) {
+			count += (above[x + dx] & CELL_MINE) >> 4;
+			count += (below[x + dx] & CELL_MINE) >> 4;
+		}
+		count += (row[x - 1] & CELL_MINE) >> 4;
+		count += (row[x + 1] & CELL_MINE) >> 4;
+		row[x] = static_cast<uint8_t>((row[x] & ~CELL_COUNT) | count);
+	}
+}
 
-	//Iterate through each cell on the board and count adjacent mines
+//Calculates the number of adjacent mines for each cell
+void Board::calculateAdjacentMines(std::vector<uint8_t>& buffer) const
+{
+	//Only mine bits are read and only count bits are written, so rows can be updated in place
 	for (int y = 0; y < height; ++y)
 	{
-		for (int x = 0; x < width; ++x)
-		{
-			if (cell[y][x].isMine) continue;
-			else
-			{
-				int mineCount = 0;
-				//Checks all 8 directions for adjacent mines
-				for (const auto& dir : directions)
-				{
-					int newX = x + dir[0];
-					int newY = y + dir[1];
-					if (newX >= 0 && newX < width && newY >= 0 && newY < height)
-					{
-						if (cell[newY][newX].isMine)
-						{
-							mineCount++;
-						}
-					}
-				}
-				//Sets count of adjacent mines for the cell
-				cell[y][x].adjacentMines = mineCount;
-			}
-		}
+		uint8_t* row = &buffer[cellIndex(0, y)];
+		countRowMines(row - stride, row, row + stride, width);
 	}
 }
 
@@ -91,79 +270,123 @@ int Board::getMineCount() const
 {
 	return mineCount;
 }
-const Cell& Board::getCell(int x, int y) const
+Cell Board::getCell(int x, int y) const
 {
-	return cell[y][x];
+	const uint8_t bits = cells[cellIndex(x, y)];
+	return Cell(firstClickHandled ? bits : static_cast<uint8_t>(bits & ~(CELL_MINE | CELL_COUNT)));
 }
 int Board::getFlagsPlaced() const { return flagsPlaced; }
+int Board::getCellsRevealed() const { return cellsRevealed; }
+const std::vector<int>& Board::getChangedCells() const { return changedCells; }
+uint64_t Board::getSeed() const { return seed; }
+int Board::getSafeRadius() const { return safeRadius; }
+void Board::setSafeRadius(int radius) { safeRadius = radius; }
 
 
 //Reveals the cell at given coordinate when selected
 void Board::revealCell(int x, int y) {
+	changedCells.clear();
+	events.clear();
 	if (x < 0 || x >= width || y < 0 || y >= height) {
 		return;
 	}
+	if (recorder) recorder->record(ACTION_REVEAL, x, y);
+	const int revealedBefore = cellsRevealed;
+	const bool overBefore = isGameOver;
+	const bool wonBefore = isGameWon;
+	const bool generating = !firstClickHandled;
 
 	if(!firstClickHandled) {
-		placeMines(x, y);
-		firstClickHandled = true;
+		generate(x, y);
 	}
 
-	Cell& current = cell[y][x];
-	if (current.isRevealed || current.isFlagged) {
+	floodReveal(cellIndex(x, y));
+
+	// Win is checked once per user action, not once per revealed cell, and never on the action that lost
+	if (!isGameOver) checkWinCondition();
+	journalAction(CELL_REVEALED, generating, x, y, revealedBefore, flagsPlaced, overBefore, wonBefore);
+	publish(revealedBefore, flagsPlaced);
+}
+
+//Reveals the cell at index and, if it has no adjacent mines, every connected zero cell and its border.
+//Uses an explicit worklist instead of recursion so large openings cannot overflow the stack.
+void Board::floodReveal(int index) {
+	uint8_t& start = cells[index];
+	if (start & (CELL_REVEALED | CELL_FLAGGED)) {
 		return;
 	}
 
-	// If mine => game over
-	if (current.isMine) {
-		isGameOver = true;
-		current.isRevealed = true;
-		++cellsRevealed;
+	// A labeled opening is revealed from its stored cell lists
+	const int first = static_cast<int>(changedCells.size());
+	if (openingsReady && !(start & (CELL_MINE | CELL_COUNT)) && revealOpening(openingOf[index])) {
+		frontierRevealed(first);
+		emit(EVENT_CELLS_REVEALED, cellX(index), cellY(index), first, static_cast<int>(changedCells.size()) - first);
 		return;
 	}
 
-	// Reveal this cell
-	current.isRevealed = true;
+	// If mine => game over; cellsRevealed only counts safe cells, so the mine is not added to it
+	start |= CELL_REVEALED;
+	changedCells.push_back(index);
+	if (start & CELL_MINE) {
+		isGameOver = true;
+		frontierRevealed(first);
+		emit(EVENT_CELLS_REVEALED, cellX(index), cellY(index), first, 1);
+		emit(EVENT_MINE_HIT, cellX(index), cellY(index));
+		return;
+	}
 	++cellsRevealed;
 
-	// Only flood-fill neighbors if this cell has 0 adjacent mines
-	if (current.adjacentMines == 0) {
-		static const std::vector<std::pair<int, int>> dirs = {
-			{-1, -1}, {-1, 0}, {-1, 1},
-			{0, -1},           {0, 1},
-			{1, -1},  {1, 0},  {1, 1}
-		};
-		for (const auto& dir : dirs) {
-			int nx = x + dir.first;
-			int ny = y + dir.second;
-			if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-				// Skip mines when expanding flood-fill to avoid revealing them and triggering game over.
-				if (cell[ny][nx].isMine) continue;
-				// Recurse; function checks flags/revealed
-				revealCell(nx, ny);
-			}
+	// Cells are marked revealed when pushed, so each cell enters the worklist at most once
+	// and the worklist never grows past the number of cells on the board.
+	// The border is stored as revealed, so no bounds checks are needed.
+	revealStack.clear();
+	revealStack.push_back(index);
+
+	while (!revealStack.empty()) {
+		int current = revealStack.back();
+		revealStack.pop_back();
+
+		// Only flood-fill neighbors if this cell has 0 adjacent mines
+		if (cells[current] & CELL_COUNT) continue;
+
+		for (int off : neighbourOffsets) {
+			int next = current + off;
+			// A zero cell has no mine neighbours, so only revealed/flagged cells need skipping
+			if (cells[next] & (CELL_REVEALED | CELL_FLAGGED)) continue;
+			cells[next] |= CELL_REVEALED;
+			++cellsRevealed;
+			revealStack.push_back(next);
+			changedCells.push_back(next);
 		}
 	}
-	if (x < 0 || x >= width || y < 0 || y >= height) {return;}
-
-	
-	checkWinCondition();
+	frontierRevealed(first);
+	emit(EVENT_CELLS_REVEALED, cellX(index), cellY(index), first, static_cast<int>(changedCells.size()) - first);
 }
 
 //Can toggle flag on a cell to mark as a mine
 void Board::toggleFlag(int x, int y) {
+	changedCells.clear();
+	events.clear();
 	if (x < 0 || x >= width || y < 0 || y >= height) {
 		throw std::out_of_range("Cell coordinates is out of range!");
 	}
-	if(cell[y][x].isRevealed) {
+	if (recorder) recorder->record(ACTION_FLAG, x, y);
+	uint8_t& c = cells[cellIndex(x, y)];
+	if(c & CELL_REVEALED) {
 		return; //Nothing happens, already revealed
 	}
+	const int flagsBefore = flagsPlaced;
+	const bool overBefore = isGameOver;
+	const bool wonBefore = isGameWon;
 
 
 	//Else, Toggle flagged state of cell
-	cell[y][x].isFlagged = !cell[y][x].isFlagged;
+	c ^= CELL_FLAGGED;
+	changedCells.push_back(cellIndex(x, y));
+	frontierUpdate(cellIndex(x, y));
+	emit(EVENT_FLAG_TOGGLED, x, y, 0, 1);
 
-	if (cell[y][x].isFlagged) {
+	if (c & CELL_FLAGGED) {
 		flagsPlaced++;
 	} else {
 		flagsPlaced--;
@@ -171,11 +394,14 @@ void Board::toggleFlag(int x, int y) {
 
 	// Re-evaluate win condition in case player wins by correctly flagging all mines
 	checkWinCondition();
+	journalAction(CELL_FLAGGED, false, x, y, cellsRevealed, flagsBefore, overBefore, wonBefore);
+	publish(cellsRevealed, flagsBefore);
 }
 
 void Board::checkWinCondition() {
 	int totalCells = width * height;
 	if(cellsRevealed == totalCells - mineCount) {
+		if (!isGameWon) emit(EVENT_GAME_WON, -1, -1);
 		isGameWon = true;
 		isGameOver = true;
 	}
@@ -191,67 +417,598 @@ bool Board::getIsGameWon() const {
 
 //Reset Board either when the user gives up/loses/wins
 void Board::resetBoard() {
+	resetBoard(prefetchEnabled ? nextSeed : makeSeed());
+}
+
+void Board::resetBoard(uint64_t seed) {
+	const int revealedBefore = cellsRevealed;
+	const int flagsBefore = flagsPlaced;
+	this->seed = seed;
 	//Reset values of all game conditions
 	firstClickHandled = false;
 	isGameOver = false;
 	isGameWon = false;
 	cellsRevealed = 0;
 	flagsPlaced = 0;
+	changedCells.clear();
+	events.clear();
+	clearJournal();
+	if (recorder) recorder->start(width, height, mineCount, seed, safeRadius);
 
-	for (int y = 0; y < height; ++y)
-	{
-		for (int x = 0; x < width; ++x)
-		{
-			//reset all values of each cell
-			cell[y][x].isFlagged = false;
-			cell[y][x].isMine = false;
-			cell[y][x].isRevealed = false;
-			cell[y][x].adjacentMines = 0;
+	//Take the prefetched layout if it is this seed's, otherwise lay out every cell again
+	if (prefetchEnabled && seed == nextSeed && mineCount == nextMineCount) {
+		waitPrefetch();
+		cells.swap(nextCells);
+		startPrefetch();
+	} else {
+		layOut(cells, seed, mineCount);
+	}
+	layoutReady = true;
+	openingsReady = false;
+	frontierClear();
+	emit(EVENT_BOARD_RESET, -1, -1);
+	publish(revealedBefore, flagsBefore);
+}
+
+void Board::setPrefetch(bool enabled) {
+	if (enabled == prefetchEnabled) return;
+	prefetchEnabled = enabled;
+	if (enabled) {
+		startPrefetch();
+	} else {
+		waitPrefetch();
+		std::vector<uint8_t>().swap(nextCells);
+	}
+}
+
+bool Board::isPrefetchReady() const {
+	return !prefetchTask.valid() || prefetchTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+//Starts laying out a fresh seed into nextCells; the previous task must have finished
+void Board::startPrefetch() {
+	nextSeed = makeSeed();
+	nextMineCount = mineCount;
+	const uint64_t layoutSeed = nextSeed;
+	const int mines = nextMineCount;
+	prefetchTask = std::async(std::launch::async, [this, layoutSeed, mines] { layOut(nextCells, layoutSeed, mines); });
+}
+
+void Board::waitPrefetch() {
+	if (prefetchTask.valid()) prefetchTask.get();
+}
+
+void Board::setFrontierTracking(bool enabled) {
+	if (enabled == trackFrontier) return;
+	trackFrontier = enabled;
+	if (enabled) {
+		frontierSlot.assign(cells.size(), -1);
+		frontierRebuild();
+	} else {
+		std::vector<int>().swap(frontier);
+		std::vector<int>().swap(frontierSlot);
+	}
+}
+
+const std::vector<int>& Board::getFrontier() const { return frontier; }
+
+//A hidden, unflagged cell belongs to the frontier while any neighbour is a revealed number
+bool Board::onFrontier(int index) const {
+	if (cells[index] & (CELL_REVEALED | CELL_FLAGGED)) return false;
+	for (int off : neighbourOffsets) {
+		const uint8_t n = cells[index + off];
+		if ((n & (CELL_REVEALED | CELL_MINE | CELL_BORDER)) == CELL_REVEALED && (n & CELL_COUNT)) return true;
+	}
+	return false;
+}
+
+void Board::frontierInsert(int index) {
+	if (frontierSlot[index] >= 0) return;
+	frontierSlot[index] = static_cast<int>(frontier.size());
+	frontier.push_back(index);
+}
+
+//Swaps the last member into the erased slot, so removal is O(1)
+void Board::frontierErase(int index) {
+	const int slot = frontierSlot[index];
+	if (slot < 0) return;
+	const int last = frontier.back();
+	frontier[slot] = last;
+	frontierSlot[last] = slot;
+	frontier.pop_back();
+	frontierSlot[index] = -1;
+}
+
+void Board::frontierUpdate(int index) {
+	if (!trackFrontier || (cells[index] & CELL_BORDER)) return;
+	if (onFrontier(index)) frontierInsert(index);
+	else frontierErase(index);
+}
+
+//Revealed cells leave the frontier and the hidden, unflagged neighbours of revealed numbers join it.
+//A revealed zero's other neighbours were revealed by the same flood (or are flagged), so only numbers add cells.
+void Board::frontierRevealed(int first) {
+	if (!trackFrontier) return;
+	for (size_t i = static_cast<size_t>(first); i < changedCells.size(); ++i) {
+		const int index = changedCells[i];
+		frontierErase(index);
+		if ((cells[index] & CELL_MINE) || !(cells[index] & CELL_COUNT)) continue;
+		for (int off : neighbourOffsets) {
+			if (!(cells[index + off] & (CELL_REVEALED | CELL_FLAGGED))) frontierInsert(index + off);
 		}
 	}
 }
 
+//O(frontier), so resets stay independent of board size
+void Board::frontierClear() {
+	for (int index : frontier) frontierSlot[index] = -1;
+	frontier.clear();
+}
+
+void Board::frontierRebuild() {
+	if (!trackFrontier) return;
+	frontierClear();
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			if (onFrontier(cellIndex(x, y))) frontierInsert(cellIndex(x, y));
+		}
+	}
+}
+
+void Board::setOpeningLabels(bool enabled) {
+	if (enabled == labelOpenings) return;
+	labelOpenings = enabled;
+	if (enabled && firstClickHandled) {
+		labelOpeningRegions();
+	} else if (!enabled) {
+		openingsReady = false;
+		std::vector<int>().swap(openingOf);
+		std::vector<int>().swap(openingStart);
+		std::vector<int>().swap(openingCells);
+		std::vector<int>().swap(borderStart);
+		std::vector<int>().swap(borderCells);
+	}
+}
+
+int Board::getOpeningCount() const { return openingsReady ? static_cast<int>(openingStart.size()) - 1 : 0; }
+
+//Labels zero cells by union-find in one row-major pass, always keeping the earlier cell as the root, so every
+//parent precedes its child and a second row-major pass can turn roots into dense opening numbers in place
+void Board::labelOpeningRegions() {
+	openingsReady = false;
+	if (!labelOpenings) return;
+	std::vector<int>& label = openingOf;
+	label.assign(cells.size(), -1);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const int index = cellIndex(x, y);
+			if (cells[index] & (CELL_MINE | CELL_COUNT)) continue;
+			uniteVisited(label, index, stride, [&](int next) { return label[next] >= 0; });
+		}
+	}
+
+	int openings = 0;
+	openingStart.assign(1, 0);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const int index = cellIndex(x, y);
+			if (label[index] < 0) continue;
+			if (label[index] == index) {
+				label[index] = openings++;
+				openingStart.push_back(0);
+			} else {
+				label[index] = label[label[index]];
+			}
+			++openingStart[label[index] + 1];
+		}
+	}
+
+	//Each number joins the border of every distinct opening around it (at most four)
+	borderStart.assign(openings + 1, 0);
+	auto bordering = [&](int index, int* found) {
+		int count = 0;
+		for (int off : neighbourOffsets) {
+			const int opening = label[index + off];
+			if (opening >= 0 && std::find(found, found + count, opening) == found + count) found[count++] = opening;
+		}
+		return count;
+	};
+	int found[8];
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const int index = cellIndex(x, y);
+			if (label[index] >= 0 || (cells[index] & CELL_MINE)) continue;
+			const int count = bordering(index, found);
+			for (int k = 0; k < count; ++k) ++borderStart[found[k] + 1];
+		}
+	}
+
+	for (int r = 0; r < openings; ++r) {
+		openingStart[r + 1] += openingStart[r];
+		borderStart[r + 1] += borderStart[r];
+	}
+	openingCells.resize(openingStart[openings]);
+	borderCells.resize(borderStart[openings]);
+	std::vector<int>& fill = movedMines; //Next free slot per opening, in the member scratch buffer
+	fill.assign(openingStart.begin(), openingStart.end() - 1);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const int index = cellIndex(x, y);
+			if (label[index] >= 0) openingCells[fill[label[index]]++] = index;
+		}
+	}
+	fill.assign(borderStart.begin(), borderStart.end() - 1);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const int index = cellIndex(x, y);
+			if (label[index] >= 0 || (cells[index] & CELL_MINE)) continue;
+			const int count = bordering(index, found);
+			for (int k = 0; k < count; ++k) borderCells[fill[found[k]]++] = index;
+		}
+	}
+	openingsReady = true;
+}
+
+//Reveals a whole opening and its border. Only an untouched opening with no flag on it or its border gives the
+//same result as the flood fill, so anything else returns false and the caller floods instead.
+bool Board::revealOpening(int opening) {
+	const int* region = openingCells.data() + openingStart[opening];
+	const int regionSize = openingStart[opening + 1] - openingStart[opening];
+	const int* border = borderCells.data() + borderStart[opening];
+	const int borderSize = borderStart[opening + 1] - borderStart[opening];
+
+	for (int i = 0; i < regionSize; ++i) {
+		if (cells[region[i]] & (CELL_REVEALED | CELL_FLAGGED)) return false;
+	}
+	int hiddenBorder = 0;
+	for (int i = 0; i < borderSize; ++i) {
+		const uint8_t c = cells[border[i]];
+		if (c & CELL_FLAGGED) return false;
+		hiddenBorder += (c & CELL_REVEALED) ? 0 : 1;
+	}
+
+	for (int i = 0; i < regionSize; ++i) cells[region[i]] |= CELL_REVEALED;
+	changedCells.insert(changedCells.end(), region, region + regionSize);
+	for (int i = 0; i < borderSize; ++i) {
+		if (cells[border[i]] & CELL_REVEALED) continue;
+		cells[border[i]] |= CELL_REVEALED;
+		changedCells.push_back(border[i]);
+	}
+	cellsRevealed += regionSize + hiddenBorder;
+	return true;
+}
+
+void Board::addListener(BoardListener* listener) {
+	listeners.push_back(listener);
+}
+
+void Board::removeListener(BoardListener* listener) {
+	listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+//Adds an event to the current batch; consecutive reveals (the floods of one chord) merge into one range
+void Board::emit(BoardEventType type, int x, int y, int first, int count) {
+	if (listeners.empty()) return;
+	if (type == EVENT_CELLS_REVEALED) {
+		if (count == 0) return;
+		if (!events.empty() && events.back().type == EVENT_CELLS_REVEALED && events.back().first + events.back().count == first) {
+			events.back().count += count;
+			return;
+		}
+	}
+	if (type == EVENT_FLAG_TOGGLED) first = static_cast<int>(changedCells.size()) - 1;
+	BoardEvent event;
+	event.type = type;
+	event.x = x;
+	event.y = y;
+	event.first = first;
+	event.count = count;
+	events.push_back(event);
+}
+
+//Sends the batch of the action that just finished to every listener
+void Board::publish(int revealedBefore, int flagsBefore) {
+	if (listeners.empty()) return;
+	if (cellsRevealed != revealedBefore || flagsPlaced != flagsBefore) emit(EVENT_COUNTERS_CHANGED, -1, -1);
+	if (events.empty()) return;
+	for (BoardListener* listener : listeners) {
+		listener->onBoardEvents(*this, events.data(), events.size());
+	}
+}
+
+void Board::setRecorder(ActionLog* log) {
+	recorder = log;
+	if (recorder) recorder->start(width, height, mineCount, seed, safeRadius);
+}
+
 void Board::chordCell(int x, int y) {
+	changedCells.clear();
+	events.clear();
 	//Basic checks to see if coordinates are valid and revealed
 	if (x < 0 || x >= width || y < 0 || y >= height) {
 		return;
 	}
-	Cell& currCell = cell[y][x];
+	if (recorder) recorder->record(ACTION_CHORD, x, y);
+	const int index = cellIndex(x, y);
+	const uint8_t currCell = cells[index];
 
 	//Check if cell is revealed and has adjacent mines
-	if (!currCell.isRevealed || currCell.adjacentMines == 0) {
+	if (!(currCell & CELL_REVEALED) || (currCell & CELL_COUNT) == 0) {
 		return;
 	}
 
-	//Count surronding flags
-	const int directions[8][2] = {
-		{-1, -1}, {-1, 0}, {-1, 1},
-		{0, -1},          {0, 1},
-		{1, -1}, {1, 0}, {1, 1}
-	};
+	//Count flags around the cell; the border is never flagged
 	int flagCount = 0;
-	//Count flags around the cell
-	for (const auto& dir : directions) {
-		int newX = x + dir[0];
-		int newY = y + dir[1];
-		if (newX >= 0 && newX < width && newY >= 0 && newY < height) {
-			if (cell[newY][newX].isFlagged) {
-				flagCount++;
-			}
+	for (int off : neighbourOffsets) {
+		if (cells[index + off] & CELL_FLAGGED) {
+			flagCount++;
 		}
 	}
 	//If flags match adjacent mines, reveal unflagged neighbors
-	if (flagCount == currCell.adjacentMines) {
-		for (const auto& dir : directions) {
-			int nx = x + dir[0];
-			int ny = y + dir[1];
-			if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-				//Only reveal unflagged cells
-				if (!cell[ny][nx].isFlagged) {
-					revealCell(nx, ny);
-				}
+	if (flagCount == (currCell & CELL_COUNT)) {
+		const int revealedBefore = cellsRevealed;
+		const bool overBefore = isGameOver;
+		const bool wonBefore = isGameWon;
+		for (int off : neighbourOffsets) {
+			//floodReveal skips flagged, revealed and border cells
+			floodReveal(index + off);
+		}
+		//A wrong flag can detonate a mine, which loses even when every safe cell is now open
+		if (!isGameOver) checkWinCondition();
+		journalAction(CELL_REVEALED, false, x, y, revealedBefore, flagsPlaced, overBefore, wonBefore);
+		publish(revealedBefore, flagsPlaced);
+	}
+}
+
+void Board::setUndoLimit(int depth, size_t maxCells) {
+	undoDepth = std::max(depth, 0);
+	undoMaxCells = maxCells;
+	if (undoDepth == 0) clearJournal();
+	else trimJournal();
+}
+
+int Board::getUndoDepth() const { return undoDepth; }
+size_t Board::getUndoMaxCells() const { return undoMaxCells; }
+
+//Forgets the oldest undoable actions while either limit is exceeded
+void Board::trimJournal() {
+	while (journalCursor > 0 && (journal.size() > static_cast<size_t>(undoDepth) || journalCells.size() > undoMaxCells)) {
+		journalCells.erase(journalCells.begin(), journalCells.begin() + journal.front().count);
+		journalBase += journal.front().count;
+		journal.pop_front();
+		--journalCursor;
+	}
+}
+
+void Board::clearJournal() {
+	journal.clear();
+	journalCells.clear();
+	journalBase = 0;
+	journalCursor = 0;
+}
+
+bool Board::canUndo() const { return journalCursor > 0; }
+bool Board::canRedo() const { return journalCursor < journal.size(); }
+
+//Stores the cells the action just changed (changedCells) and how the counters and game state moved
+void Board::journalAction(uint8_t mask, bool generated, int x, int y, int revealedBefore, int flagsBefore, bool overBefore, bool wonBefore) {
+	if (undoDepth == 0 || (changedCells.empty() && !generated)) return;
+
+	//A new action forgets whatever could have been redone
+	while (journal.size() > journalCursor) {
+		journalCells.erase(journalCells.end() - journal.back().count, journalCells.end());
+		journal.pop_back();
+	}
+
+	JournalEntry entry;
+	entry.mask = mask;
+	entry.generated = generated;
+	entry.x = x;
+	entry.y = y;
+	entry.start = journalBase + journalCells.size();
+	entry.count = static_cast<int>(changedCells.size());
+	entry.revealedDelta = cellsRevealed - revealedBefore;
+	entry.flagsDelta = flagsPlaced - flagsBefore;
+	entry.overBefore = overBefore;
+	entry.wonBefore = wonBefore;
+	entry.overAfter = isGameOver;
+	entry.wonAfter = isGameWon;
+	journalCells.insert(journalCells.end(), changedCells.begin(), changedCells.end());
+	journal.push_back(entry);
+	journalCursor = journal.size();
+	trimJournal();
+}
+
+bool Board::undo() {
+	changedCells.clear();
+	events.clear();
+	if (journalCursor == 0) return false;
+	const JournalEntry& entry = journal[journalCursor - 1];
+	const int revealedBefore = cellsRevealed;
+	const int flagsBefore = flagsPlaced;
+
+	const size_t first = entry.start - journalBase;
+	for (size_t i = first; i < first + entry.count; ++i) {
+		cells[journalCells[i]] ^= entry.mask;
+		changedCells.push_back(journalCells[i]);
+	}
+	cellsRevealed -= entry.revealedDelta;
+	flagsPlaced -= entry.flagsDelta;
+	isGameOver = entry.overBefore;
+	isGameWon = entry.wonBefore;
+
+	//Back to before the first click: drop the layout but keep flags, so the next click generates again
+	if (entry.generated) {
+		for (int y = 0; y < height; ++y) {
+			uint8_t* row = &cells[cellIndex(0, y)];
+			for (int x = 0; x < width; ++x) row[x] &= static_cast<uint8_t>(~(CELL_MINE | CELL_COUNT));
+		}
+		markBorder(cells);
+		firstClickHandled = false;
+		layoutReady = false;
+		openingsReady = false;
+	}
+	for (int index : changedCells) {
+		frontierUpdate(index);
+		for (int off : neighbourOffsets) frontierUpdate(index + off);
+	}
+	if (entry.count > 0) emit(EVENT_CELLS_RESTORED, entry.x, entry.y, 0, entry.count);
+	if (entry.overAfter && !entry.overBefore) emit(EVENT_GAME_RESUMED, -1, -1);
+	--journalCursor;
+	if (recorder) recorder->record(ACTION_UNDO);
+	publish(revealedBefore, flagsBefore);
+	return true;
+}
+
+bool Board::redo() {
+	changedCells.clear();
+	events.clear();
+	if (journalCursor == journal.size()) return false;
+	const JournalEntry& entry = journal[journalCursor];
+	const int revealedBefore = cellsRevealed;
+	const int flagsBefore = flagsPlaced;
+
+	//Same seed and click, so the same layout as the first time
+	if (entry.generated) generate(entry.x, entry.y);
+	const size_t first = entry.start - journalBase;
+	for (size_t i = first; i < first + entry.count; ++i) {
+		cells[journalCells[i]] ^= entry.mask;
+		changedCells.push_back(journalCells[i]);
+	}
+	cellsRevealed += entry.revealedDelta;
+	flagsPlaced += entry.flagsDelta;
+	isGameOver = entry.overAfter;
+	isGameWon = entry.wonAfter;
+	for (int index : changedCells) {
+		frontierUpdate(index);
+		for (int off : neighbourOffsets) frontierUpdate(index + off);
+	}
+	if (entry.count > 0) emit(EVENT_CELLS_RESTORED, entry.x, entry.y, 0, entry.count);
+	if (entry.overAfter && !entry.overBefore && entry.wonAfter) {
+		emit(EVENT_GAME_WON, -1, -1);
+	} else if (entry.overAfter && !entry.overBefore) {
+		//The move is replayed as a whole, so find the mine it uncovered among its cells
+		for (int index : changedCells) {
+			if ((cells[index] & (CELL_MINE | CELL_REVEALED)) == (CELL_MINE | CELL_REVEALED)) {
+				emit(EVENT_MINE_HIT, cellX(index), cellY(index));
+				break;
 			}
 		}
 	}
+	++journalCursor;
+	if (recorder) recorder->record(ACTION_REDO);
+	publish(revealedBefore, flagsBefore);
+	return true;
+}
+
+//Packs the bit of eight consecutive cells (each byte holding 0 or 1) into one byte, cell k in bit k.
+//The multiply moves byte k to bit 56 + k; every partial product lands on a distinct bit, so nothing carries.
+//Byte k is cell k because loads are little-endian on every target this builds for.
+static inline uint64_t packBits(const uint8_t* cells, int shift)
+{
+	uint64_t v;
+	std::memcpy(&v, cells, 8);
+	v = (v >> shift) & 0x0101010101010101ull;
+	return (v * 0x0102040810204080ull) >> 56;
+}
+
+void Board::exportPlanes(uint64_t* mines, uint64_t* revealed, uint64_t* flagged) const
+{
+	const int words = rowWords();
+	for (int y = 0; y < height; ++y) {
+		const uint8_t* row = &cells[cellIndex(0, y)];
+		uint64_t* m = mines + static_cast<size_t>(y) * words;
+		uint64_t* r = revealed + static_cast<size_t>(y) * words;
+		uint64_t* f = flagged + static_cast<size_t>(y) * words;
+		std::fill(m, m + words, 0ull);
+		std::fill(r, r + words, 0ull);
+		std::fill(f, f + words, 0ull);
+
+		//Before the first click the mines are not final, so they are not part of the game's state
+		int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const int shift = x & 63;
+			if (firstClickHandled) m[x >> 6] |= packBits(row + x, 4) << shift;
+			r[x >> 6] |= packBits(row + x, 5) << shift;
+			f[x >> 6] |= packBits(row + x, 6) << shift;
+		}
+		for (; x < width; ++x) {
+			const uint64_t bit = 1ull << (x & 63);
+			if (firstClickHandled && (row[x] & CELL_MINE)) m[x >> 6] |= bit;
+			if (row[x] & CELL_REVEALED) r[x >> 6] |= bit;
+			if (row[x] & CELL_FLAGGED) f[x >> 6] |= bit;
+		}
+	}
+}
+
+//spread[b] has byte k set to bit k of b, so eight cells unpack with one lookup per plane
+struct SpreadTable {
+	uint64_t bytes[256];
+	SpreadTable() {
+		for (int b = 0; b < 256; ++b) {
+			uint64_t v = 0;
+			for (int k = 0; k < 8; ++k) v |= static_cast<uint64_t>((b >> k) & 1) << (8 * k);
+			bytes[b] = v;
+		}
+	}
+};
+
+void Board::importPlanes(const uint64_t* mines, const uint64_t* revealed, const uint64_t* flagged, uint64_t seed)
+{
+	static const SpreadTable table;
+	const uint64_t* spread = table.bytes;
+	const int words = rowWords();
+	const int revealedBefore = cellsRevealed;
+	const int flagsBefore = flagsPlaced;
+	int placed = 0;
+	cellsRevealed = 0;
+	flagsPlaced = 0;
+	isGameOver = false;
+
+	for (int y = 0; y < height; ++y) {
+		uint8_t* row = &cells[cellIndex(0, y)];
+		const uint64_t* m = mines + static_cast<size_t>(y) * words;
+		const uint64_t* r = revealed + static_cast<size_t>(y) * words;
+		const uint64_t* f = flagged + static_cast<size_t>(y) * words;
+		for (int w = 0; w < words; ++w) {
+			placed += static_cast<int>(std::bitset<64>(m[w]).count());
+			cellsRevealed += static_cast<int>(std::bitset<64>(r[w] & ~m[w]).count());
+			flagsPlaced += static_cast<int>(std::bitset<64>(f[w]).count());
+			isGameOver |= (m[w] & r[w]) != 0;
+		}
+
+		int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const int word = x >> 6;
+			const int shift = x & 63;
+			const uint64_t v = (spread[(m[word] >> shift) & 0xFF] << 4) | (spread[(r[word] >> shift) & 0xFF] << 5)
+				| (spread[(f[word] >> shift) & 0xFF] << 6);
+			std::memcpy(row + x, &v, 8);
+		}
+		for (; x < width; ++x) {
+			const int word = x >> 6;
+			const int shift = x & 63;
+			row[x] = static_cast<uint8_t>((((m[word] >> shift) & 1) << 4) | (((r[word] >> shift) & 1) << 5)
+				| (((f[word] >> shift) & 1) << 6));
+		}
+	}
+	calculateAdjacentMines(cells);
+
+	//A board with no mines and nothing revealed was saved before its first click and will generate on the next one
+	this->seed = seed;
+	firstClickHandled = placed > 0 || cellsRevealed > 0;
+	layoutReady = false;
+	if (firstClickHandled) mineCount = placed;
+	isGameWon = false;
+	changedCells.clear();
+	events.clear();
+	clearJournal();
+	frontierRebuild();
+	if (firstClickHandled) labelOpeningRegions();
+	else openingsReady = false;
+	emit(EVENT_BOARD_RESET, -1, -1);
+	if (!isGameOver) checkWinCondition();
+	publish(revealedBefore, flagsBefore);
 }
+
 //End of Board.cpp
\ No newline at end of file
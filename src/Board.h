@@ -3,8 +3,24 @@
 #ifndef BOARD_H
 #define BOARD_H
 #include <vector>
-#include <FL/Fl_PNG_Image.H>
+#include <deque>
+#include <future>
+#include <cstdint>
+#include <cstddef>
 
+class ActionLog;
+class Board;
+
+//Bit layout of the one byte Board stores per cell
+enum CellBits : uint8_t {
+	CELL_COUNT = 0x0F, //Adjacent mine count (0-8)
+	CELL_MINE = 0x10,
+	CELL_REVEALED = 0x20,
+	CELL_FLAGGED = 0x40,
+	CELL_BORDER = 0x80 //Sentinel ring around the board, always stored as revealed
+};
+
+//Read-only view of one cell, unpacked from the board's byte storage
 struct Cell {
 	bool isMine;
 	bool isRevealed;
@@ -12,37 +28,222 @@ struct Cell {
 	int adjacentMines;
 
 	Cell() : isMine(false), isRevealed(false), isFlagged(false), adjacentMines(0) {}
+	explicit Cell(uint8_t bits)
+		: isMine((bits & CELL_MINE) != 0), isRevealed((bits & CELL_REVEALED) != 0),
+		  isFlagged((bits & CELL_FLAGGED) != 0), adjacentMines(bits & CELL_COUNT) {}
+};
+
+//What an action changed, published to BoardListeners in one batch per action
+enum BoardEventType : uint8_t {
+	EVENT_CELLS_REVEALED, //Cells [first, first + count) of getChangedCells() were revealed
+	EVENT_CELLS_RESTORED, //Undo/redo flipped cells [first, first + count) of getChangedCells()
+	EVENT_FLAG_TOGGLED, //(x, y), which is getChangedCells()[first]
+	EVENT_MINE_HIT, //(x, y) is the mine that ended the game
+	EVENT_GAME_WON,
+	EVENT_GAME_RESUMED, //Undo took back the move that ended the game
+	EVENT_COUNTERS_CHANGED, //getCellsRevealed() or getFlagsPlaced() moved
+	EVENT_BOARD_RESET //Any cell may have changed (new game, restored snapshot)
+};
+
+struct BoardEvent {
+	BoardEventType type;
+	int x;
+	int y;
+	int first;
+	int count;
+};
+
+//Receives the events of each action once it has finished. The batch and getChangedCells() are reused by the
+//next action, and the board must not be changed from inside the callback.
+class BoardListener {
+	public:
+		virtual ~BoardListener() {}
+		virtual void onBoardEvents(const Board& board, const BoardEvent* events, size_t count) = 0;
 };
 
 class Board {
 	public:
 		Board(int width, int height, int mineCount);
+		Board(int width, int height, int mineCount, uint64_t seed); //Same seed + first click => same layout
+		~Board();
 		void revealCell(int x, int y);
 		void toggleFlag(int x, int y);
 		int getWidth() const;
 		int getHeight() const;
-		const Cell& getCell(int x, int y) const;
+		Cell getCell(int x, int y) const;
 		int getMineCount() const;
 
-        
+
         bool getIsGameOver() const;
         bool getIsGameWon() const;
-		void resetBoard();
+		void resetBoard(); //Starts a new game with a fresh seed
+		void resetBoard(uint64_t seed); //Starts a new game that replays the layout of seed
+
+		//Lays out the next game's mines on a background thread while this one is played, so resetBoard()
+		//only swaps buffers and costs the same at any size. Doubles the cell storage; off by default.
+		void setPrefetch(bool enabled);
+		bool isPrefetchReady() const; //The next resetBoard() will not wait for the background layout
+
+		uint64_t getSeed() const;
+		//Mines are kept out of the (2r+1)x(2r+1) square around the first click; 1 (3x3) by default.
+		//Falls back to protecting only the clicked cell when the board is too dense for the full zone.
+		void setSafeRadius(int radius);
+		int getSafeRadius() const;
 
 		int getFlagsPlaced() const; //new function to get number of flags placed
+		int getCellsRevealed() const; //Safe cells only; a detonated mine is not counted
+
+		//Cells changed by the last revealCell/toggleFlag/chordCell, as cell indices (see cellIndex).
+		//Cleared at the start of every action, so a GUI can repaint only what changed.
+		const std::vector<int>& getChangedCells() const;
+
+		//Cell indices address the padded storage: index = (y + 1) * (width + 2) + (x + 1)
+		int cellIndex(int x, int y) const { return (y + 1) * stride + (x + 1); }
+		int cellX(int index) const { return index % stride - 1; }
+		int cellY(int index) const { return index / stride - 1; }
+
+		//Lays out the mines as if (firstX, firstY) had been clicked, without revealing anything.
+		//The next revealCell then plays on this layout. Used by tools that inspect or time generation.
+		//The seed alone fixes the layout when the board is reset; the click only moves the mines in its
+		//safe zone elsewhere, so this costs O(safe zone) after a reset.
+		void generate(int firstX, int firstY);
 
 		//Chord addition
 		void chordCell(int x, int y);
 
+		//Undo/redo journal. Each action keeps only the cells it changed plus counter deltas, so undoing or redoing
+		//costs the size of that action (undoing the first click also clears the layout, which is O(board)).
+		//Keeps the last depth actions and at most maxCells journaled cells; off (depth 0) by default.
+		void setUndoLimit(int depth, size_t maxCells = 1 << 24); //Lowering it forgets the oldest actions at once
+		int getUndoDepth() const;
+		size_t getUndoMaxCells() const;
+		bool undo(); //Returns false if there is nothing to undo; getChangedCells() lists the cells it restored
+		bool redo();
+		bool canUndo() const;
+		bool canRedo() const;
+
+		//Hidden, unflagged cells next to a revealed number, as cell indices in no particular order. While tracking
+		//is on (4 bytes per cell) every action keeps it current, so reading it never scans the board; off by default.
+		void setFrontierTracking(bool enabled);
+		const std::vector<int>& getFrontier() const;
+
+		//Labels the openings (connected zero areas) of each layout once it is final, so revealing a zero cell
+		//uncovers its whole opening plus border in one pass over stored cell lists instead of a flood fill.
+		//Costs an O(board) labeling pass per layout and about 4-8 bytes per cell; off by default.
+		void setOpeningLabels(bool enabled);
+		int getOpeningCount() const; //0 until a layout has been labeled
+
+		//Listeners are called in the order added; events are only collected while at least one is registered
+		void addListener(BoardListener* listener);
+		void removeListener(BoardListener* listener);
+
+		//Every revealCell/toggleFlag/chordCell on an in-range cell is appended to log (nullptr stops recording).
+		//Attaching starts a fresh log for the current seed, so attach before the first move; resetBoard restarts it.
+		void setRecorder(ActionLog* log);
+
+		//Bit planes for snapshots: one bit per cell (bit x % 64 of word x / 64), each row padded to rowWords() words
+		int rowWords() const { return (width + 63) / 64; }
+		void exportPlanes(uint64_t* mines, uint64_t* revealed, uint64_t* flagged) const;
+		//Restores a game saved with exportPlanes on a board of the same size.
+		//Counts, counters and the game-over state are rebuilt from the planes.
+		void importPlanes(const uint64_t* mines, const uint64_t* revealed, const uint64_t* flagged, uint64_t seed);
+
 
 	private:
 		int width;
 		int height;
 		int mineCount;
-		std::vector<std::vector<Cell>> cell;
-		void placeMines(int ClickX, int ClickY);
-		void calculateAdjacentMines();
+
+		//Cells are stored row-major in one byte array with a one-cell border on every side,
+		//so neighbour visits never need bounds checks
+		int stride; //width + 2
+		std::vector<uint8_t> cells;
+		int neighbourOffsets[8];
+
+		uint64_t seed;
+		int safeRadius;
+		std::vector<int> movedMines;
+		static uint64_t makeSeed();
+
+		//Mines and counts are hidden from getCell until the first click; until then they are the seed's layout
+		//(when layoutReady) or absent
+		bool layoutReady;
+		void layOut(std::vector<uint8_t>& buffer, uint64_t layoutSeed, int mines) const;
+		void placeMines(std::vector<uint8_t>& buffer, uint64_t layoutSeed, int mines) const;
+		void clearSafeZone(int ClickX, int ClickY);
+		void addMine(int index);
+		void removeMine(int index);
+		void calculateAdjacentMines(std::vector<uint8_t>& buffer) const;
+		void floodReveal(int index);
 		void checkWinCondition();
+		void clearCells(std::vector<uint8_t>& buffer) const;
+		void markBorder(std::vector<uint8_t>& buffer) const;
+
+		//Double buffer for prefetching: the background task only ever touches nextCells
+		bool prefetchEnabled;
+		std::vector<uint8_t> nextCells;
+		uint64_t nextSeed;
+		int nextMineCount;
+		std::future<void> prefetchTask;
+		void startPrefetch();
+		void waitPrefetch();
+
+		std::vector<int> revealStack; //Flood fill worklist, reused between calls
+		std::vector<int> changedCells; //Cells touched by the current action, reused between calls
+		ActionLog* recorder;
+
+		//Frontier as a sparse set: frontierSlot[index] is the cell's position in frontier, or -1
+		bool trackFrontier;
+		std::vector<int> frontier;
+		std::vector<int> frontierSlot;
+		bool onFrontier(int index) const;
+		void frontierInsert(int index);
+		void frontierErase(int index);
+		void frontierUpdate(int index); //Re-checks one cell after an arbitrary change
+		void frontierRevealed(int first); //Fast path for changedCells[first..] having just been revealed
+		void frontierClear();
+		void frontierRebuild();
+
+		//Openings in CSR form: openingOf[index] is the opening of a zero cell (-1 for any other cell); opening r owns
+		//openingCells[openingStart[r] .. openingStart[r + 1]) and borders borderCells[borderStart[r] .. borderStart[r + 1])
+		bool labelOpenings;
+		bool openingsReady;
+		std::vector<int> openingOf;
+		std::vector<int> openingStart;
+		std::vector<int> openingCells;
+		std::vector<int> borderStart;
+		std::vector<int> borderCells;
+		void labelOpeningRegions();
+		bool revealOpening(int opening);
+
+		std::vector<BoardListener*> listeners;
+		std::vector<BoardEvent> events; //Batch of the current action, reused between calls
+		void emit(BoardEventType type, int x, int y, int first = 0, int count = 0);
+		void publish(int revealedBefore, int flagsBefore);
+
+		struct JournalEntry {
+			uint8_t mask; //Bit flipped on each of its cells: CELL_REVEALED or CELL_FLAGGED
+			bool generated; //The action was the first click, which laid out the mines around (x, y)
+			int x;
+			int y;
+			size_t start; //Position of its first cell in journalCells, counted from the start of the journal
+			int count;
+			int revealedDelta;
+			int flagsDelta;
+			bool overBefore;
+			bool wonBefore;
+			bool overAfter;
+			bool wonAfter;
+		};
+		std::deque<JournalEntry> journal;
+		std::deque<int> journalCells; //Changed cells of every journaled action, oldest first
+		size_t journalBase; //Position of journalCells.front()
+		size_t journalCursor; //Entries before the cursor can be undone, the rest redone
+		int undoDepth;
+		size_t undoMaxCells;
+		void journalAction(uint8_t mask, bool generated, int x, int y, int revealedBefore, int flagsBefore, bool overBefore, bool wonBefore);
+		void clearJournal();
+		void trimJournal();
 
 		bool firstClickHandled;
 		bool isGameOver;
@@ -53,4 +254,4 @@ class Board {
 
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,91 @@
+#include "BoardAnalyzer.h"
+#include "UnionFind.h"
+#include <algorithm>
+
+enum CellKind : uint8_t { KIND_OTHER, KIND_ZERO, KIND_ISOLATED };
+
+BoardAnalyzer::BoardAnalyzer(int threads) : pool(threads)
+{
+}
+
+BoardMetrics BoardAnalyzer::analyze(const Board& board)
+{
+	return analyze(board, scratch);
+}
+
+BoardMetrics BoardAnalyzer::analyze(const Board& board, Scratch& scratch)
+{
+	const int width = board.getWidth();
+	const int height = board.getHeight();
+	const int stride = width + 2;
+	const size_t padded = static_cast<size_t>(stride) * (height + 2);
+
+	std::vector<int8_t>& values = scratch.values;
+	values.assign(padded, -1);
+	for (int y = 0; y < height; ++y) {
+		int8_t* row = &values[static_cast<size_t>(y + 1) * stride + 1];
+		for (int x = 0; x < width; ++x) {
+			const Cell c = board.getCell(x, y);
+			row[x] = static_cast<int8_t>(c.isMine ? 9 : c.adjacentMines);
+		}
+	}
+	std::vector<uint8_t>& kinds = scratch.kinds;
+	kinds.assign(padded, KIND_OTHER);
+	std::vector<int>& parent = scratch.parent;
+	parent.resize(padded);
+
+	const int around[8] = { -stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1 };
+
+	BoardMetrics metrics;
+	int zeros = 0;
+	int zeroMerges = 0;
+	int islandMerges = 0;
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const int index = (y + 1) * stride + (x + 1);
+			const int8_t value = values[index];
+			if (value == 9) continue;
+
+			uint8_t kind = KIND_ZERO;
+			if (value != 0) {
+				bool opened = false;
+				for (int off : around) opened |= values[index + off] == 0;
+				if (opened) continue;
+				kind = KIND_ISOLATED;
+			}
+			kinds[index] = kind;
+			//Earlier neighbours already have their kind and root
+			const int merges = uniteVisited(parent, index, stride, [&](int next) { return kinds[next] == kind; });
+			(kind == KIND_ZERO ? zeroMerges : islandMerges) += merges;
+			if (kind == KIND_ZERO) ++zeros;
+			else ++metrics.isolatedNumbers;
+		}
+	}
+
+	//Every cell starts its own group and every successful merge joins two
+	metrics.openings = zeros - zeroMerges;
+	metrics.islands = metrics.isolatedNumbers - islandMerges;
+	metrics.bbbv = metrics.openings + metrics.isolatedNumbers;
+	return metrics;
+}
+
+void BoardAnalyzer::analyzeSeeds(int width, int height, int mineCount, int firstX, int firstY,
+	const std::vector<uint64_t>& seeds, std::vector<BoardMetrics>& metrics)
+{
+	//Blocks of seeds share one board and one scratch, so a batch allocates once per block
+	const size_t blockSize = 256;
+	const int blocks = static_cast<int>((seeds.size() + blockSize - 1) / blockSize);
+	metrics.resize(seeds.size());
+	pool.parallelFor(blocks, [&](int block) {
+		Board board(width, height, mineCount, 0);
+		Scratch local;
+		const size_t end = std::min(seeds.size(), (block + 1) * blockSize);
+		for (size_t i = block * blockSize; i < end; ++i) {
+			board.resetBoard(seeds[i]);
+			board.generate(firstX, firstY);
+			metrics[i] = analyze(board, local);
+		}
+	});
+}
+
+//End of BoardAnalyzer.cpp
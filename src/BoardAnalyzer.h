@@ -0,0 +1,47 @@
+#pragma once
+#ifndef BOARDANALYZER_H
+#define BOARDANALYZER_H
+#include <vector>
+#include <cstdint>
+#include "Board.h"
+#include "ThreadPool.h"
+
+//Difficulty of one laid-out board
+struct BoardMetrics {
+	int bbbv; //3BV: the fewest left clicks that clear the board without flags or chords (openings + isolated numbers)
+	int openings; //Connected areas of zero cells; one click clears each along with its border
+	int isolatedNumbers; //Number cells that border no opening, so each needs a click of its own
+	int islands; //Connected groups of isolated numbers
+
+	BoardMetrics() : bbbv(0), openings(0), isolatedNumbers(0), islands(0) {}
+};
+
+//Scores boards in one row-major labeling pass: each zero cell and each isolated number is merged with its
+//already-visited neighbours of the same kind through union-find, and every new root is a new opening or island.
+//Batches of seeds are laid out and scored in parallel across the pool.
+class BoardAnalyzer {
+	public:
+		explicit BoardAnalyzer(int threads = 0); //0 = one thread per hardware core
+
+		//The board's mines must be laid out (first click played, or generate called)
+		BoardMetrics analyze(const Board& board);
+
+		//Lays out every seed with a first click on (firstX, firstY) and scores it; metrics[i] belongs to seeds[i]
+		void analyzeSeeds(int width, int height, int mineCount, int firstX, int firstY,
+			const std::vector<uint64_t>& seeds, std::vector<BoardMetrics>& metrics);
+
+	private:
+		//Per-thread working memory, reused from board to board
+		struct Scratch {
+			std::vector<int8_t> values; //Padded grid: count 0-8, 9 for a mine, -1 for the border
+			std::vector<uint8_t> kinds;
+			std::vector<int> parent;
+		};
+
+		ThreadPool pool;
+		Scratch scratch;
+
+		static BoardMetrics analyze(const Board& board, Scratch& scratch);
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include "BoardSnapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char snapshotMagic[8] = { 'M', 'S', 'W', 'P', 'S', 'A', 'V', '\0' };
+
+bool BoardSnapshot::save(const std::string& path, const Board& board, const SnapshotInfo& info)
+{
+	Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+	header.version = version;
+	header.headerSize = sizeof(Header);
+	header.width = board.getWidth();
+	header.height = board.getHeight();
+	header.mineCount = board.getMineCount();
+	header.secondsElapsed = info.secondsElapsed;
+	header.seed = board.getSeed();
+	header.timerRunning = info.timerRunning ? 1 : 0;
+	header.rowWords = static_cast<uint32_t>(board.rowWords());
+	header.planeOffset = (sizeof(Header) + 63) & ~static_cast<uint64_t>(63);
+	header.planeWords = static_cast<uint64_t>(header.rowWords) * header.height;
+
+	const size_t words = static_cast<size_t>(header.planeWords);
+	std::vector<uint64_t> planes(words * 3);
+	board.exportPlanes(planes.data(), planes.data() + words, planes.data() + 2 * words);
+
+	//Write to a temporary name first so a failed save never destroys the previous one
+	const std::string temporary = path + ".tmp";
+	FILE* file = std::fopen(temporary.c_str(), "wb");
+	if (!file) return false;
+	const char padding[64] = {};
+	bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+	ok = ok && std::fwrite(padding, 1, header.planeOffset - sizeof(header), file) == header.planeOffset - sizeof(header);
+	ok = ok && std::fwrite(planes.data(), sizeof(uint64_t), planes.size(), file) == planes.size();
+	ok = std::fclose(file) == 0 && ok;
+	if (!ok) {
+		std::remove(temporary.c_str());
+		return false;
+	}
+	std::remove(path.c_str());
+	return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+BoardSnapshot::BoardSnapshot(const std::string& path) : data(nullptr), size(0), header(nullptr)
+{
+#ifdef _WIN32
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return;
+	fileHandle = file;
+	LARGE_INTEGER length;
+	if (!GetFileSizeEx(file, &length) || length.QuadPart < static_cast<LONGLONG>(sizeof(Header))) return;
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) return;
+	mappingHandle = mapping;
+	data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!data) return;
+	size = static_cast<size_t>(length.QuadPart);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) return;
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+		close(file);
+		return;
+	}
+	void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file); //The mapping keeps the file alive
+	if (mapped == MAP_FAILED) return;
+	data = static_cast<const unsigned char*>(mapped);
+	size = static_cast<size_t>(info.st_size);
+#endif
+
+	//Only accept headers whose planes fit in the file
+	const Header* candidate = reinterpret_cast<const Header*>(data);
+	const bool ok = std::memcmp(candidate->magic, snapshotMagic, sizeof(snapshotMagic)) == 0
+		&& candidate->version == version && candidate->headerSize == sizeof(Header)
+		&& candidate->width > 0 && candidate->height > 0
+		&& candidate->rowWords == static_cast<uint32_t>((candidate->width + 63) / 64)
+		&& candidate->planeWords == static_cast<uint64_t>(candidate->rowWords) * candidate->height
+		&& candidate->planeOffset % 64 == 0 && candidate->planeOffset >= sizeof(Header)
+		&& candidate->planeOffset + candidate->planeWords * 3 * sizeof(uint64_t) <= size;
+	if (ok) header = candidate;
+}
+
+BoardSnapshot::~BoardSnapshot()
+{
+	unmap();
+}
+
+void BoardSnapshot::unmap()
+{
+#ifdef _WIN32
+	if (data) UnmapViewOfFile(data);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle) CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if (data) munmap(const_cast<unsigned char*>(data), size);
+#endif
+	data = nullptr;
+	size = 0;
+	header = nullptr;
+}
+
+bool BoardSnapshot::isValid() const { return header != nullptr; }
+int BoardSnapshot::getWidth() const { return header ? header->width : 0; }
+int BoardSnapshot::getHeight() const { return header ? header->height : 0; }
+int BoardSnapshot::getMineCount() const { return header ? header->mineCount : 0; }
+uint64_t BoardSnapshot::getSeed() const { return header ? header->seed : 0; }
+
+SnapshotInfo BoardSnapshot::getInfo() const
+{
+	SnapshotInfo info;
+	if (header) {
+		info.secondsElapsed = header->secondsElapsed;
+		info.timerRunning = header->timerRunning != 0;
+	}
+	return info;
+}
+
+bool BoardSnapshot::restore(Board& board) const
+{
+	if (!header || board.getWidth() != header->width || board.getHeight() != header->height) {
+		return false;
+	}
+	//planeOffset is 64-byte aligned and mappings start on a page, so the planes can be read in place
+	const uint64_t* planes = reinterpret_cast<const uint64_t*>(data + header->planeOffset);
+	const size_t words = static_cast<size_t>(header->planeWords);
+	board.importPlanes(planes, planes + words, planes + 2 * words, header->seed);
+	return true;
+}
+
+//End of BoardSnapshot.cpp
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef BOARDSNAPSHOT_H
+#define BOARDSNAPSHOT_H
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Board.h"
+
+//State kept next to the board so a window can resume exactly where it stopped
+struct SnapshotInfo {
+	int secondsElapsed;
+	bool timerRunning;
+
+	SnapshotInfo() : secondsElapsed(0), timerRunning(false) {}
+};
+
+//Versioned binary save file. A fixed header (sizes, seed, window state) is followed by the mine,
+//revealed and flagged planes, 3 bits per cell in total. Loading maps the file and hands the planes
+//straight to Board::importPlanes, so nothing is parsed per cell.
+class BoardSnapshot {
+	public:
+		static const uint32_t version = 1;
+
+		//Writes board and info to path; returns false if the file could not be written
+		static bool save(const std::string& path, const Board& board, const SnapshotInfo& info);
+
+		//Maps path read-only; check isValid() before using the getters
+		explicit BoardSnapshot(const std::string& path);
+		~BoardSnapshot();
+		BoardSnapshot(const BoardSnapshot&) = delete;
+		BoardSnapshot& operator=(const BoardSnapshot&) = delete;
+
+		bool isValid() const;
+		int getWidth() const;
+		int getHeight() const;
+		int getMineCount() const;
+		uint64_t getSeed() const;
+		SnapshotInfo getInfo() const;
+
+		//Restores the saved game; board must have been created with getWidth() x getHeight()
+		bool restore(Board& board) const;
+
+	private:
+		struct Header {
+			char magic[8];
+			uint32_t version;
+			uint32_t headerSize;
+			int32_t width;
+			int32_t height;
+			int32_t mineCount;
+			int32_t secondsElapsed;
+			uint64_t seed;
+			uint32_t timerRunning;
+			uint32_t rowWords;
+			uint64_t planeOffset; //Byte offset of the first plane, 64-byte aligned
+			uint64_t planeWords; //Words per plane
+		};
+
+		const unsigned char* data;
+		size_t size;
+		const Header* header;
+#ifdef _WIN32
+		void* fileHandle;
+		void* mappingHandle;
+#endif
+
+		void unmap();
+};
+
+#endif
@@ -0,0 +1,265 @@
+#include "BoardView.h"
+#include <FL/fl_draw.H>
+#include <algorithm>
+
+BoardView::BoardView(int X, int Y, int W, int H, Board& board)
+: Fl_Widget(X, Y, W, H), board(board), cellSize(30), originX(0), originY(0), clickX(-1), clickY(-1), clickButton(0),
+  panning(false), panStartX(0), panStartY(0), showMines(false), explodedX(-1), explodedY(-1), imgMine(nullptr), imgFlag(nullptr)
+{
+	box(FL_FLAT_BOX);
+	color(FL_BACKGROUND_COLOR);
+}
+
+void BoardView::setImages(Fl_PNG_Image* mine, Fl_PNG_Image* flag)
+{
+	imgMine = mine;
+	imgFlag = flag;
+}
+
+//Keeps the view inside the board; a board smaller than the view stays pinned to the top-left
+void BoardView::clampOrigin()
+{
+	originX = std::max(0, std::min(originX, board.getWidth() * cellSize - w()));
+	originY = std::max(0, std::min(originY, board.getHeight() * cellSize - h()));
+}
+
+void BoardView::setCellSize(int size, int anchorX, int anchorY)
+{
+	//std::min/max take references; copies keep the in-class constants from needing a definition
+	const int smallest = minCellSize;
+	const int largest = maxCellSize;
+	size = std::max(smallest, std::min(size, largest));
+	if (size == cellSize) return;
+	//Board position under the anchor, in cells, stays under the anchor after zooming
+	const double boardX = (anchorX + originX) / static_cast<double>(cellSize);
+	const double boardY = (anchorY + originY) / static_cast<double>(cellSize);
+	cellSize = size;
+	originX = static_cast<int>(boardX * cellSize) - anchorX;
+	originY = static_cast<int>(boardY * cellSize) - anchorY;
+	clampOrigin();
+	redraw();
+}
+
+void BoardView::scrollTo(int px, int py)
+{
+	const int oldX = originX;
+	const int oldY = originY;
+	originX = px;
+	originY = py;
+	clampOrigin();
+	if (originX != oldX || originY != oldY) redraw();
+}
+
+void BoardView::resize(int X, int Y, int W, int H)
+{
+	Fl_Widget::resize(X, Y, W, H);
+	clampOrigin();
+}
+
+void BoardView::damageCells(const int* indices, size_t count)
+{
+	//Past a few hundred rectangles one full repaint of the visible area is cheaper than a damage region
+	if (count > 256) {
+		redraw();
+		return;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		const int index = indices[i];
+		const int px = x() + board.cellX(index) * cellSize - originX;
+		const int py = y() + board.cellY(index) * cellSize - originY;
+		if (px + cellSize <= x() || py + cellSize <= y() || px >= x() + w() || py >= y() + h()) continue;
+		damage(FL_DAMAGE_USER1, px, py, cellSize, cellSize);
+	}
+}
+
+void BoardView::revealMines(int explodeX, int explodeY)
+{
+	showMines = true;
+	explodedX = explodeX;
+	explodedY = explodeY;
+	redraw();
+}
+
+void BoardView::clearReveal()
+{
+	showMines = false;
+	explodedX = -1;
+	explodedY = -1;
+	redraw();
+}
+
+//Draws only the visible cells that intersect the current clip region
+void BoardView::draw()
+{
+	int clipX, clipY, clipW, clipH;
+	fl_clip_box(x(), y(), w(), h(), clipX, clipY, clipW, clipH);
+	if (clipW <= 0 || clipH <= 0) return;
+
+	fl_push_clip(clipX, clipY, clipW, clipH);
+	if (damage() & FL_DAMAGE_ALL) {
+		//Area right/below the grid when the view is larger than the board
+		fl_rectf(clipX, clipY, clipW, clipH, color());
+	}
+	if (cellSize >= detailCellSize) drawDetailed(clipX, clipY, clipW, clipH);
+	else drawOverview(clipX, clipY, clipW, clipH);
+	fl_pop_clip();
+}
+
+void BoardView::drawDetailed(int clipX, int clipY, int clipW, int clipH)
+{
+	const int firstX = std::max((clipX - x() + originX) / cellSize, 0);
+	const int firstY = std::max((clipY - y() + originY) / cellSize, 0);
+	const int lastX = std::min((clipX + clipW - 1 - x() + originX) / cellSize, board.getWidth() - 1);
+	const int lastY = std::min((clipY + clipH - 1 - y() + originY) / cellSize, board.getHeight() - 1);
+	for (int cy = firstY; cy <= lastY; ++cy) {
+		for (int cx = firstX; cx <= lastX; ++cx) {
+			drawCell(cx, cy, x() + cx * cellSize - originX, y() + cy * cellSize - originY);
+		}
+	}
+}
+
+//Level of detail for small zoom: every pixel takes the colour of the cell under it, built into one
+//RGB buffer and blitted at once, so the cost is bounded by the clip area rather than the board
+void BoardView::drawOverview(int clipX, int clipY, int clipW, int clipH)
+{
+	static const unsigned char hiddenRgb[3] = { 160, 160, 160 };
+	static const unsigned char flagRgb[3] = { 230, 40, 40 };
+	static const unsigned char mineRgb[3] = { 0, 0, 0 };
+	static const unsigned char explodedRgb[3] = { 255, 0, 0 };
+	static const unsigned char countRgb[9][3] = {
+		{ 235, 235, 235 }, { 150, 170, 255 }, { 130, 210, 130 }, { 255, 140, 140 }, { 120, 120, 210 },
+		{ 190, 110, 110 }, { 110, 190, 190 }, { 90, 90, 90 }, { 150, 150, 150 }
+	};
+	static const unsigned char outsideRgb[3] = { 212, 208, 200 };
+
+	pixels.resize(static_cast<size_t>(clipW) * clipH * 3);
+	unsigned char* out = pixels.data();
+	for (int py = 0; py < clipH; ++py) {
+		const int cy = (clipY + py - y() + originY) / cellSize;
+		for (int px = 0; px < clipW; ++px) {
+			const int cx = (clipX + px - x() + originX) / cellSize;
+			const unsigned char* rgb = outsideRgb;
+			if (cx < board.getWidth() && cy < board.getHeight()) {
+				const Cell c = board.getCell(cx, cy);
+				if (c.isMine && (c.isRevealed || showMines)) rgb = (cx == explodedX && cy == explodedY) ? explodedRgb : mineRgb;
+				else if (c.isRevealed) rgb = countRgb[c.adjacentMines];
+				else if (c.isFlagged) rgb = flagRgb;
+				else rgb = hiddenRgb;
+			}
+			*out++ = rgb[0];
+			*out++ = rgb[1];
+			*out++ = rgb[2];
+		}
+	}
+	fl_draw_image(pixels.data(), clipX, clipY, clipW, clipH, 3, 0);
+}
+
+void BoardView::drawImage(Fl_PNG_Image* image, int px, int py)
+{
+	fl_push_clip(px, py, cellSize, cellSize);
+	image->draw(px + (cellSize - image->w()) / 2, py + (cellSize - image->h()) / 2);
+	fl_pop_clip();
+}
+
+void BoardView::drawCell(int cx, int cy, int px, int py)
+{
+	//Static labels so repaints never allocate strings
+	static const char* const countLabels[9] = { "", "1", "2", "3", "4", "5", "6", "7", "8" };
+	const Cell c = board.getCell(cx, cy);
+
+	if (c.isRevealed || (showMines && c.isMine)) {
+		const bool exploded = cx == explodedX && cy == explodedY;
+		fl_draw_box(FL_FLAT_BOX, px, py, cellSize, cellSize, exploded ? FL_RED : FL_BACKGROUND_COLOR);
+		if (c.isMine) {
+			if (imgMine) drawImage(imgMine, px, py);
+			else {
+				fl_color(FL_RED);
+				fl_draw("*", px, py, cellSize, cellSize, FL_ALIGN_CENTER);
+			}
+		} else if (c.adjacentMines > 0) {
+			switch (c.adjacentMines) {
+				case 1: fl_color(FL_BLUE); break;
+				case 2: fl_color(FL_GREEN); break;
+				case 3: fl_color(FL_RED); break;
+				default: fl_color(FL_DARK_BLUE); break;
+			}
+			fl_font(FL_HELVETICA, std::min(14, cellSize * 14 / 30 + 1));
+			fl_draw(countLabels[c.adjacentMines], px, py, cellSize, cellSize, FL_ALIGN_CENTER);
+		}
+		return;
+	}
+
+	// Unrevealed cells: show flag if flagged, otherwise blank
+	fl_draw_box(FL_UP_BOX, px, py, cellSize, cellSize, FL_BACKGROUND_COLOR);
+	if (c.isFlagged) {
+		if (imgFlag) drawImage(imgFlag, px, py);
+		else {
+			fl_color(FL_RED);
+			fl_draw("F", px, py, cellSize, cellSize, FL_ALIGN_CENTER);
+		}
+	}
+}
+
+int BoardView::handle(int event)
+{
+	const int mouseX = Fl::event_x() - x();
+	const int mouseY = Fl::event_y() - y();
+	switch (event) {
+		case FL_PUSH: {
+			take_focus();
+			if (Fl::event_state() & FL_SHIFT) {
+				panning = true;
+				panStartX = mouseX + originX;
+				panStartY = mouseY + originY;
+				return 1;
+			}
+			//Map the press to its cell with arithmetic and hand it to the callback
+			const int cx = (mouseX + originX) / cellSize;
+			const int cy = (mouseY + originY) / cellSize;
+			if (mouseX < 0 || mouseY < 0 || cx >= board.getWidth() || cy >= board.getHeight()) return 1;
+			clickX = cx;
+			clickY = cy;
+			clickButton = Fl::event_button();
+			do_callback();
+			return 1;
+		}
+		case FL_DRAG:
+			if (panning) scrollTo(panStartX - mouseX, panStartY - mouseY);
+			return 1;
+		case FL_RELEASE:
+			panning = false;
+			return 1;
+		case FL_MOUSEWHEEL:
+			if (Fl::event_state() & FL_CTRL) {
+				//Zoom steps of about 25%, always by at least one pixel
+				int step = std::max(1, cellSize / 4);
+				setCellSize(Fl::event_dy() < 0 ? cellSize + step : cellSize - step, mouseX, mouseY);
+			} else if (Fl::event_state() & FL_SHIFT) {
+				scrollTo(originX + (Fl::event_dy() + Fl::event_dx()) * cellSize * 3, originY);
+			} else {
+				scrollTo(originX + Fl::event_dx() * cellSize * 3, originY + Fl::event_dy() * cellSize * 3);
+			}
+			return 1;
+		case FL_FOCUS:
+		case FL_UNFOCUS:
+			return 1;
+		case FL_KEYDOWN: {
+			const int page = std::max(cellSize, w() / 4);
+			switch (Fl::event_key()) {
+				case FL_Left: scrollTo(originX - page, originY); return 1;
+				case FL_Right: scrollTo(originX + page, originY); return 1;
+				case FL_Up: scrollTo(originX, originY - page); return 1;
+				case FL_Down: scrollTo(originX, originY + page); return 1;
+				case '+': case '=': setCellSize(cellSize + std::max(1, cellSize / 4), w() / 2, h() / 2); return 1;
+				case '-': setCellSize(cellSize - std::max(1, cellSize / 4), w() / 2, h() / 2); return 1;
+				default: break;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+	return Fl_Widget::handle(event);
+}
+
+//End of BoardView.cpp
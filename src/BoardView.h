@@ -0,0 +1,70 @@
+#pragma once
+#ifndef BOARDVIEW_H
+#define BOARDVIEW_H
+#include <vector>
+#include <FL/Fl.H>
+#include <FL/Fl_Widget.H>
+#include <FL/Fl_PNG_Image.H>
+#include "Board.h"
+
+//Scrollable, zoomable viewport onto a Board. Only the visible cells are drawn, a click is mapped to its
+//cell arithmetically and reported through the widget callback, and repaints are clipped to damaged cells.
+//Zoomed out below detailCellSize the view switches to a flat colour per cell (down to one pixel per cell).
+//Controls: wheel / Shift+wheel scroll, Ctrl+wheel or +/- zoom, arrow keys scroll, Shift+drag pans.
+class BoardView : public Fl_Widget {
+	public:
+		BoardView(int X, int Y, int W, int H, Board& board);
+
+		void draw() override;
+		int handle(int event) override;
+		void resize(int X, int Y, int W, int H) override;
+
+		//Cell and mouse button of the click that fired the callback
+		int eventCellX() const { return clickX; }
+		int eventCellY() const { return clickY; }
+		int eventButton() const { return clickButton; }
+
+		void setImages(Fl_PNG_Image* mine, Fl_PNG_Image* flag);
+		int getCellSize() const { return cellSize; }
+		//Zoom to size pixels per cell, keeping the board point under (anchorX, anchorY) in place
+		void setCellSize(int size, int anchorX = 0, int anchorY = 0);
+		//Scroll so the board pixel (px, py) at the current zoom is at the top-left corner
+		void scrollTo(int px, int py);
+
+		//Queue a repaint of the given cells (see Board::cellIndex); falls back to one full redraw for big changes
+		void damageCells(const int* indices, size_t count);
+		//Show every mine (end of game); the exploded cell, if any, gets a red background
+		void revealMines(int explodeX, int explodeY);
+		//Back to normal play after a reset
+		void clearReveal();
+
+		static const int minCellSize = 1;
+		static const int maxCellSize = 64;
+		static const int detailCellSize = 12;
+
+	private:
+		Board& board;
+		int cellSize;
+		int originX; //Board pixel at the left edge of the view
+		int originY; //Board pixel at the top edge of the view
+		int clickX;
+		int clickY;
+		int clickButton;
+		bool panning;
+		int panStartX;
+		int panStartY;
+		bool showMines;
+		int explodedX;
+		int explodedY;
+		Fl_PNG_Image* imgMine;
+		Fl_PNG_Image* imgFlag;
+		std::vector<unsigned char> pixels; //RGB buffer for the zoomed-out view, reused between draws
+
+		void clampOrigin();
+		void drawDetailed(int clipX, int clipY, int clipW, int clipH);
+		void drawOverview(int clipX, int clipY, int clipW, int clipH);
+		void drawCell(int cx, int cy, int px, int py);
+		void drawImage(Fl_PNG_Image* image, int px, int py);
+};
+
+#endif
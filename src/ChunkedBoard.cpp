@@ -0,0 +1,389 @@
+#include "ChunkedBoard.h"
+#include "Random.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstring>
+
+//Nothing is allocated here; chunks appear as play reaches them
+ChunkedBoard::ChunkedBoard(int width, int height, long long mineCount, uint64_t seed)
+{
+	if (width <= 0 || height <= 0) {
+		throw std::invalid_argument("Board dimensions must be positive");
+	}
+	this->width = width;
+	this->height = height;
+	this->mineCount = mineCount;
+	this->chunksX = (width + chunkSize - 1) / chunkSize;
+	this->chunksY = (height + chunkSize - 1) / chunkSize;
+	resetBoard(seed);
+}
+
+int ChunkedBoard::getWidth() const { return width; }
+int ChunkedBoard::getHeight() const { return height; }
+long long ChunkedBoard::getMineCount() const { return mineCount; }
+long long ChunkedBoard::getFlagsPlaced() const { return flagsPlaced; }
+long long ChunkedBoard::getCellsRevealed() const { return cellsRevealed; }
+bool ChunkedBoard::getIsGameOver() const { return isGameOver; }
+bool ChunkedBoard::getIsGameWon() const { return isGameWon; }
+uint64_t ChunkedBoard::getSeed() const { return seed; }
+size_t ChunkedBoard::getChunkCount() const { return chunks.size(); }
+
+//Dropping the chunk map is the whole reset, so it costs O(explored area)
+void ChunkedBoard::resetBoard(uint64_t seed)
+{
+	this->seed = seed;
+	chunks.clear();
+	cachedKey = -1;
+	cachedChunk = nullptr;
+	firstClickHandled = false;
+	safeCount = 0;
+	isGameOver = false;
+	isGameWon = false;
+	cellsRevealed = 0;
+	flagsPlaced = 0;
+}
+
+ChunkedBoard::Chunk* ChunkedBoard::findChunk(int chunkX, int chunkY) const
+{
+	auto it = chunks.find(static_cast<long long>(chunkY) * chunksX + chunkX);
+	return it == chunks.end() ? nullptr : it->second.get();
+}
+
+//Allocates the chunk if needed, without laying mines (flags can be placed before the first click)
+ChunkedBoard::Chunk& ChunkedBoard::touchChunk(int chunkX, int chunkY)
+{
+	std::unique_ptr<Chunk>& slot = chunks[static_cast<long long>(chunkY) * chunksX + chunkX];
+	if (!slot) {
+		slot.reset(new Chunk);
+		std::memset(slot->cells, 0, sizeof(slot->cells));
+		slot->minesReady = false;
+		slot->countsReady = false;
+	}
+	return *slot;
+}
+
+//Chunk with its mines laid; only possible once the first click fixed the safe zone
+ChunkedBoard::Chunk& ChunkedBoard::minedChunk(int chunkX, int chunkY)
+{
+	Chunk& chunk = touchChunk(chunkX, chunkY);
+	if (!chunk.minesReady && firstClickHandled) {
+		layMines(chunkX, chunkY, chunk.cells);
+		chunk.minesReady = true;
+	}
+	return chunk;
+}
+
+//Chunk with adjacent mine counts, which needs the mines of the eight chunks around it
+ChunkedBoard::Chunk& ChunkedBoard::countedChunk(int chunkX, int chunkY)
+{
+	const long long key = static_cast<long long>(chunkY) * chunksX + chunkX;
+	if (key == cachedKey) return *cachedChunk;
+
+	Chunk& chunk = minedChunk(chunkX, chunkY);
+	if (!chunk.countsReady && firstClickHandled) {
+		const Chunk* around[3][3];
+		for (int dy = -1; dy <= 1; ++dy) {
+			for (int dx = -1; dx <= 1; ++dx) {
+				const int nx = chunkX + dx;
+				const int ny = chunkY + dy;
+				const bool inside = nx >= 0 && nx < chunksX && ny >= 0 && ny < chunksY;
+				around[dy + 1][dx + 1] = inside ? &minedChunk(nx, ny) : nullptr;
+			}
+		}
+
+		//Mine bits of the chunk plus a one-cell ring taken from its neighbours (zero outside the board)
+		const int padded = chunkSize + 2;
+		uint8_t mines[padded * padded];
+		for (int ly = -1; ly <= chunkSize; ++ly) {
+			const int row = ly < 0 ? 0 : (ly < chunkSize ? 1 : 2);
+			const int srcY = (ly + chunkSize) & (chunkSize - 1);
+			for (int lx = -1; lx <= chunkSize; ++lx) {
+				const int col = lx < 0 ? 0 : (lx < chunkSize ? 1 : 2);
+				const int srcX = (lx + chunkSize) & (chunkSize - 1);
+				const Chunk* source = around[row][col];
+				mines[(ly + 1) * padded + lx + 1] = source ? (source->cells[srcY * chunkSize + srcX] & CELL_MINE) >> 4 : 0;
+			}
+		}
+
+		for (int ly = 0; ly < chunkSize; ++ly) {
+			const uint8_t* above = &mines[ly * padded + 1];
+			const uint8_t* here = above + padded;
+			const uint8_t* below = here + padded;
+			uint8_t* out = &chunk.cells[ly * chunkSize];
+			for (int lx = 0; lx < chunkSize; ++lx) {
+				const int count = above[lx - 1] + above[lx] + above[lx + 1] + here[lx - 1] + here[lx + 1]
+					+ below[lx - 1] + below[lx] + below[lx + 1];
+				out[lx] = static_cast<uint8_t>((out[lx] & ~CELL_COUNT) | count);
+			}
+		}
+		chunk.countsReady = true;
+	}
+
+	//Only cache finished chunks, so a chunk touched before the first click is counted later
+	if (chunk.countsReady) {
+		cachedKey = key;
+		cachedChunk = &chunk;
+	}
+	return chunk;
+}
+
+uint8_t& ChunkedBoard::cellAt(int x, int y)
+{
+	Chunk& chunk = countedChunk(x >> chunkShift, y >> chunkShift);
+	return chunk.cells[(y & (chunkSize - 1)) * chunkSize + (x & (chunkSize - 1))];
+}
+
+//Number of cells in chunks [0, chunkIndex) in row-major chunk order; edge chunks are clipped to the board
+long long ChunkedBoard::cellsBefore(long long chunkIndex) const
+{
+	const long long chunkRow = chunkIndex / chunksX;
+	const long long chunkCol = chunkIndex % chunksX;
+	const long long fullRows = std::min<long long>(chunkRow * chunkSize, height) * width;
+	if (chunkRow >= chunksY) return fullRows;
+	const long long rowHeight = std::min<long long>(chunkSize, height - chunkRow * chunkSize);
+	return fullRows + rowHeight * std::min<long long>(chunkCol * chunkSize, width);
+}
+
+//Cells of chunks [first, last) that may hold a mine
+long long ChunkedBoard::capacity(long long first, long long last) const
+{
+	long long cells = cellsBefore(last) - cellsBefore(first);
+	for (int i = 0; i < safeCount; ++i) {
+		const long long chunk = static_cast<long long>(safeY[i] >> chunkShift) * chunksX + (safeX[i] >> chunkShift);
+		if (chunk >= first && chunk < last) --cells;
+	}
+	return cells;
+}
+
+//How many of mines, spread uniformly over left + right cells, fall in the left part (hypergeometric).
+//Small counts are drawn exactly one mine at a time; large ones use the normal approximation,
+//which only decides how the top levels of the tree divide millions of mines.
+long long ChunkedBoard::splitMines(long long mines, long long left, long long right, uint64_t nodeSeed)
+{
+	if (mines == 0 || left == 0) return 0;
+	if (right == 0) return mines;
+
+	Random rng(nodeSeed);
+	if (mines <= 1024) {
+		long long toLeft = 0;
+		for (long long i = 0; i < mines; ++i) {
+			const double total = static_cast<double>(left + right);
+			if (static_cast<double>(rng.next() >> 11) * 0x1.0p-53 * total < static_cast<double>(left)) {
+				++toLeft;
+				--left;
+			} else {
+				--right;
+			}
+		}
+		return toLeft;
+	}
+
+	const double total = static_cast<double>(left + right);
+	const double share = static_cast<double>(left) / total;
+	const double mean = mines * share;
+	const double variance = mines * share * (1.0 - share) * (total - mines) / std::max(total - 1.0, 1.0);
+	//Box-Muller on two 53-bit uniforms; 1 - u keeps the log argument above zero
+	const double u = 1.0 - static_cast<double>(rng.next() >> 11) * 0x1.0p-53;
+	const double v = static_cast<double>(rng.next() >> 11) * 0x1.0p-53;
+	const double z = std::sqrt(-2.0 * std::log(u)) * std::cos(6.283185307179586 * v);
+	const long long drawn = std::llround(mean + std::sqrt(variance) * z);
+	return std::min(std::max(drawn, std::max(0LL, mines - right)), std::min(mines, left));
+}
+
+//Walks the binary tree of chunk ranges from the root, splitting the mine total at every level.
+//Each node's split only depends on the seed and the node, so every chunk agrees with every other one.
+long long ChunkedBoard::minesInChunk(long long chunkIndex) const
+{
+	long long first = 0;
+	long long last = static_cast<long long>(chunksX) * chunksY;
+	long long mines = mineCount;
+	while (last - first > 1) {
+		const long long mid = first + (last - first) / 2;
+		const long long toLeft = splitMines(mines, capacity(first, mid), capacity(mid, last),
+			hashSeed(seed, static_cast<uint64_t>(first), static_cast<uint64_t>(last)));
+		if (chunkIndex < mid) {
+			last = mid;
+			mines = toLeft;
+		} else {
+			first = mid;
+			mines -= toLeft;
+		}
+	}
+	return mines;
+}
+
+//Sets the mine bits of one chunk with Floyd's sampling over its cells outside the safe zone
+void ChunkedBoard::layMines(int chunkX, int chunkY, uint8_t* cells) const
+{
+	const int originX = chunkX * chunkSize;
+	const int originY = chunkY * chunkSize;
+	const int w = std::min(chunkSize, width - originX);
+	const int h = std::min(chunkSize, height - originY);
+
+	//Safe cells inside this chunk as ranks over its w x h cells, ascending because safe cells are row-major
+	int safe[9];
+	int inside = 0;
+	for (int i = 0; i < safeCount; ++i) {
+		if (safeX[i] >= originX && safeX[i] < originX + w && safeY[i] >= originY && safeY[i] < originY + h) {
+			safe[inside++] = (safeY[i] - originY) * w + (safeX[i] - originX);
+		}
+	}
+	auto cellAtRank = [&](int rank) {
+		for (int i = 0; i < inside; ++i) {
+			if (safe[i] <= rank) ++rank;
+		}
+		return (rank / w) * chunkSize + rank % w;
+	};
+
+	const long long chunkIndex = static_cast<long long>(chunkY) * chunksX + chunkX;
+	const int available = w * h - inside;
+	const int mines = static_cast<int>(minesInChunk(chunkIndex));
+	Random rng(hashSeed(seed, static_cast<uint64_t>(chunkIndex), ~0ull));
+	for (int j = available - mines; j < available; ++j) {
+		int index = cellAtRank(static_cast<int>(rng.below(static_cast<uint32_t>(j) + 1)));
+		if (cells[index] & CELL_MINE) index = cellAtRank(j);
+		cells[index] |= CELL_MINE;
+	}
+}
+
+Cell ChunkedBoard::getCell(int x, int y) const
+{
+	const Chunk* chunk = findChunk(x >> chunkShift, y >> chunkShift);
+	if (!chunk) return Cell();
+	return Cell(chunk->cells[(y & (chunkSize - 1)) * chunkSize + (x & (chunkSize - 1))]);
+}
+
+//Lays out the chunk holding (x, y) if needed; always false before the first click
+bool ChunkedBoard::hasMine(int x, int y)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height || !firstClickHandled) {
+		return false;
+	}
+	const Chunk& chunk = minedChunk(x >> chunkShift, y >> chunkShift);
+	return (chunk.cells[(y & (chunkSize - 1)) * chunkSize + (x & (chunkSize - 1))] & CELL_MINE) != 0;
+}
+
+void ChunkedBoard::revealCell(int x, int y)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height) {
+		return;
+	}
+
+	if (!firstClickHandled) {
+		//Same 3x3 safe zone as Board, shrinking to the clicked cell on boards too dense for it
+		const long long totalCells = static_cast<long long>(width) * height;
+		safeCount = 0;
+		for (int sy = y - 1; sy <= y + 1; ++sy) {
+			for (int sx = x - 1; sx <= x + 1; ++sx) {
+				if (sx >= 0 && sx < width && sy >= 0 && sy < height) {
+					safeX[safeCount] = sx;
+					safeY[safeCount] = sy;
+					++safeCount;
+				}
+			}
+		}
+		if (mineCount > totalCells - safeCount) {
+			safeX[0] = x;
+			safeY[0] = y;
+			safeCount = 1;
+		}
+		mineCount = std::min(mineCount, totalCells - safeCount);
+		firstClickHandled = true;
+	}
+
+	floodReveal(x, y);
+	if (!isGameOver) checkWinCondition();
+}
+
+//Iterative flood fill over global coordinates; each chunk is laid out and counted when the fill reaches it
+void ChunkedBoard::floodReveal(int x, int y)
+{
+	uint8_t& start = cellAt(x, y);
+	if (start & (CELL_REVEALED | CELL_FLAGGED)) {
+		return;
+	}
+	//Like Board, a detonated mine is revealed but not counted
+	start |= CELL_REVEALED;
+	if (start & CELL_MINE) {
+		isGameOver = true;
+		return;
+	}
+	++cellsRevealed;
+
+	//Cells are marked revealed when pushed, so each one enters the worklist at most once
+	revealStack.clear();
+	revealStack.push_back(static_cast<long long>(y) * width + x);
+	while (!revealStack.empty()) {
+		const long long current = revealStack.back();
+		revealStack.pop_back();
+		const int cx = static_cast<int>(current % width);
+		const int cy = static_cast<int>(current / width);
+		if (cellAt(cx, cy) & CELL_COUNT) continue;
+
+		for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, height - 1); ++ny) {
+			for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, width - 1); ++nx) {
+				uint8_t& next = cellAt(nx, ny);
+				if (next & (CELL_REVEALED | CELL_FLAGGED)) continue;
+				next |= CELL_REVEALED;
+				++cellsRevealed;
+				revealStack.push_back(static_cast<long long>(ny) * width + nx);
+			}
+		}
+	}
+}
+
+void ChunkedBoard::toggleFlag(int x, int y)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height) {
+		throw std::out_of_range("Cell coordinates is out of range!");
+	}
+	Chunk& chunk = touchChunk(x >> chunkShift, y >> chunkShift);
+	uint8_t& c = chunk.cells[(y & (chunkSize - 1)) * chunkSize + (x & (chunkSize - 1))];
+	if (c & CELL_REVEALED) {
+		return;
+	}
+	c ^= CELL_FLAGGED;
+	if (c & CELL_FLAGGED) {
+		flagsPlaced++;
+	} else {
+		flagsPlaced--;
+	}
+	checkWinCondition();
+}
+
+void ChunkedBoard::chordCell(int x, int y)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height) {
+		return;
+	}
+	const uint8_t current = cellAt(x, y);
+	if (!(current & CELL_REVEALED) || (current & CELL_COUNT) == 0) {
+		return;
+	}
+
+	int flagCount = 0;
+	for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1); ++ny) {
+		for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1); ++nx) {
+			if (cellAt(nx, ny) & CELL_FLAGGED) flagCount++;
+		}
+	}
+	if (flagCount == (current & CELL_COUNT)) {
+		for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1); ++ny) {
+			for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1); ++nx) {
+				floodReveal(nx, ny);
+			}
+		}
+		if (!isGameOver) checkWinCondition();
+	}
+}
+
+void ChunkedBoard::checkWinCondition()
+{
+	if (firstClickHandled && cellsRevealed == static_cast<long long>(width) * height - mineCount) {
+		isGameWon = true;
+		isGameOver = true;
+	}
+}
+
+//End of ChunkedBoard.cpp
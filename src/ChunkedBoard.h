@@ -0,0 +1,85 @@
+#pragma once
+#ifndef CHUNKEDBOARD_H
+#define CHUNKEDBOARD_H
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include "Board.h"
+
+//Board variant for very large boards: cells live in 64x64 chunks that are only allocated when a reveal,
+//flag or mine query first touches them. How many mines each chunk holds is derived from the seed by
+//splitting the total down a binary tree of chunk ranges, and the layout inside a chunk comes from its own
+//seeded stream, so untouched chunks cost nothing and any chunk can be rebuilt at any time.
+//Memory and startup time scale with the explored area instead of the declared size.
+class ChunkedBoard {
+	public:
+		static const int chunkShift = 6;
+		static const int chunkSize = 1 << chunkShift;
+
+		ChunkedBoard(int width, int height, long long mineCount, uint64_t seed);
+
+		void revealCell(int x, int y);
+		void toggleFlag(int x, int y);
+		void chordCell(int x, int y);
+		//Cells of chunks nothing has touched yet read as hidden; use hasMine to query their layout
+		Cell getCell(int x, int y) const;
+		bool hasMine(int x, int y);
+
+		int getWidth() const;
+		int getHeight() const;
+		long long getMineCount() const;
+		long long getFlagsPlaced() const;
+		long long getCellsRevealed() const;
+		bool getIsGameOver() const;
+		bool getIsGameWon() const;
+		uint64_t getSeed() const;
+		size_t getChunkCount() const; //Chunks currently allocated
+
+		void resetBoard(uint64_t seed);
+
+	private:
+		struct Chunk {
+			uint8_t cells[chunkSize * chunkSize]; //Same bit layout as Board (CellBits), no border
+			bool minesReady;
+			bool countsReady;
+		};
+
+		int width;
+		int height;
+		long long mineCount;
+		uint64_t seed;
+		int chunksX;
+		int chunksY;
+		std::unordered_map<long long, std::unique_ptr<Chunk>> chunks;
+
+		bool firstClickHandled;
+		int safeX[9]; //Cells kept clear around the first click, in row-major order
+		int safeY[9];
+		int safeCount;
+		bool isGameOver;
+		bool isGameWon;
+		long long cellsRevealed;
+		long long flagsPlaced;
+
+		std::vector<long long> revealStack; //Flood fill worklist, reused between calls
+		long long cachedKey; //Last chunk handed out by countedChunk; floods stay in one chunk most of the time
+		Chunk* cachedChunk;
+
+		Chunk* findChunk(int chunkX, int chunkY) const;
+		Chunk& touchChunk(int chunkX, int chunkY);
+		Chunk& minedChunk(int chunkX, int chunkY);
+		Chunk& countedChunk(int chunkX, int chunkY);
+		uint8_t& cellAt(int x, int y); //Chunk with counts, materialized on demand
+
+		long long cellsBefore(long long chunkIndex) const;
+		long long capacity(long long first, long long last) const;
+		long long minesInChunk(long long chunkIndex) const;
+		static long long splitMines(long long mines, long long left, long long right, uint64_t nodeSeed);
+		void layMines(int chunkX, int chunkY, uint8_t* cells) const;
+
+		void floodReveal(int x, int y);
+		void checkWinCondition();
+};
+
+#endif
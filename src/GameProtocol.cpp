@@ -0,0 +1,182 @@
+#include "GameProtocol.h"
+#include <cstdint>
+
+//Parses an optionally signed decimal after any spaces; false if there is none
+static bool parseNumber(const char*& p, const char* end, long long& value)
+{
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+	bool negative = p < end && *p == '-';
+	if (negative) ++p;
+	if (p == end || *p < '0' || *p > '9') return false;
+	unsigned long long v = 0;
+	while (p < end && *p >= '0' && *p <= '9') v = v * 10 + static_cast<unsigned>(*p++ - '0');
+	value = negative ? -static_cast<long long>(v) : static_cast<long long>(v);
+	return true;
+}
+
+static void appendNumber(std::string& out, unsigned long long v)
+{
+	char digits[20];
+	int n = 0;
+	do {
+		digits[n++] = static_cast<char>('0' + v % 10);
+		v /= 10;
+	} while (v);
+	while (n) out.push_back(digits[--n]);
+}
+
+static void appendError(std::string& out, const char* message)
+{
+	out += "e ";
+	out += message;
+	out.push_back('\n');
+}
+
+GameProtocol::GameProtocol() : playing(false), closed(false)
+{
+}
+
+bool GameProtocol::isClosed() const { return closed; }
+
+void GameProtocol::restart(long long keepCells)
+{
+	if (board && static_cast<long long>(board->getWidth()) * board->getHeight() > keepCells) board.reset();
+	playing = false;
+	closed = false;
+}
+
+char GameProtocol::status() const
+{
+	if (board->getIsGameWon()) return 'w';
+	return board->getIsGameOver() ? 'l' : 'p';
+}
+
+char GameProtocol::cellChar(int x, int y) const
+{
+	const Cell c = board->getCell(x, y);
+	if (c.isRevealed) return c.isMine ? '*' : static_cast<char>('0' + c.adjacentMines);
+	return c.isFlagged ? 'F' : '.';
+}
+
+void GameProtocol::execute(const char* line, size_t length, std::string& out)
+{
+	const char* p = line;
+	const char* end = line + length;
+	while (p < end && *p == ' ') ++p;
+	if (p == end) {
+		appendError(out, "empty command");
+		return;
+	}
+	const char command = *p++;
+	if (command == 'N') {
+		newGame(p, end, out);
+		return;
+	}
+	if (command == 'Q') {
+		closed = true;
+		out += "bye\n";
+		return;
+	}
+	if (!playing) {
+		appendError(out, "no game; start one with N");
+		return;
+	}
+	if (command == 'S') {
+		appendState(out);
+		return;
+	}
+
+	long long x, y;
+	if (command != 'R' && command != 'F' && command != 'C') {
+		appendError(out, "unknown command");
+		return;
+	}
+	if (!parseNumber(p, end, x) || !parseNumber(p, end, y)) {
+		appendError(out, "expected x y");
+		return;
+	}
+	if (x < 0 || y < 0 || x >= board->getWidth() || y >= board->getHeight()) {
+		appendError(out, "cell out of range");
+		return;
+	}
+	const int cx = static_cast<int>(x);
+	const int cy = static_cast<int>(y);
+	if (command == 'R' && board->getCell(cx, cy).isFlagged) {
+		//A flagged cell is protected, as in the GUI
+		out.push_back(status());
+		out += " 0\n";
+		return;
+	}
+	if (command == 'R') {
+		board->revealCell(cx, cy);
+	} else if (command == 'F') {
+		board->toggleFlag(cx, cy);
+	} else {
+		board->chordCell(cx, cy);
+	}
+	appendChanges(out);
+}
+
+void GameProtocol::newGame(const char* p, const char* end, std::string& out)
+{
+	long long width, height, mines, seed;
+	if (!parseNumber(p, end, width) || !parseNumber(p, end, height) || !parseNumber(p, end, mines)) {
+		appendError(out, "expected N w h m [seed]");
+		return;
+	}
+	if (width < 1 || height < 1 || width > maxSide || height > maxSide || mines < 0 || mines >= width * height) {
+		appendError(out, "bad board size or mine count");
+		return;
+	}
+	const bool seeded = parseNumber(p, end, seed);
+
+	if (board && board->getWidth() == width && board->getHeight() == height && board->getMineCount() == mines) {
+		if (seeded) board->resetBoard(static_cast<uint64_t>(seed));
+		else board->resetBoard();
+	} else if (seeded) {
+		board.reset(new Board(static_cast<int>(width), static_cast<int>(height), static_cast<int>(mines), static_cast<uint64_t>(seed)));
+	} else {
+		board.reset(new Board(static_cast<int>(width), static_cast<int>(height), static_cast<int>(mines)));
+	}
+	playing = true;
+	out += "p ";
+	appendNumber(out, board->getSeed());
+	out.push_back('\n');
+}
+
+void GameProtocol::appendChanges(std::string& out) const
+{
+	const std::vector<int>& changed = board->getChangedCells();
+	out.push_back(status());
+	out.push_back(' ');
+	appendNumber(out, changed.size());
+	for (int index : changed) {
+		const int x = board->cellX(index);
+		const int y = board->cellY(index);
+		out.push_back(' ');
+		appendNumber(out, static_cast<unsigned long long>(x));
+		out.push_back(' ');
+		appendNumber(out, static_cast<unsigned long long>(y));
+		out.push_back(' ');
+		out.push_back(cellChar(x, y));
+	}
+	out.push_back('\n');
+}
+
+void GameProtocol::appendState(std::string& out) const
+{
+	const int width = board->getWidth();
+	const int height = board->getHeight();
+	out.push_back(status());
+	out.push_back(' ');
+	appendNumber(out, static_cast<unsigned long long>(width));
+	out.push_back(' ');
+	appendNumber(out, static_cast<unsigned long long>(height));
+	out.push_back(' ');
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) out.push_back(cellChar(x, y));
+	}
+	out.push_back('\n');
+}
+
+//End of GameProtocol.cpp
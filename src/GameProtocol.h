@@ -0,0 +1,43 @@
+#pragma once
+#ifndef GAMEPROTOCOL_H
+#define GAMEPROTOCOL_H
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <climits>
+#include "Board.h"
+
+//Line protocol for bots: one command per line, exactly one reply line per command. Commands map straight
+//onto Board; replies start with the game status (p playing, w won, l lost) or e for an error.
+//  N w h m [seed]   new game (same size and mine count reuses the board) -> p seed
+//  R x y / F x y / C x y   reveal / toggle flag / chord -> status k, then x y v for each of the k changed cells
+//  S                whole board -> status w h and one character per cell, row-major
+//  Q                close -> bye
+//Cell characters: 0-8 revealed number, * revealed mine, F flagged, . hidden.
+//Replies are appended to a caller-owned buffer, so once it has grown, play commands allocate nothing.
+class GameProtocol {
+	public:
+		static const int maxSide = 10000; //Same limit as the GUI
+
+		GameProtocol();
+
+		//Runs one command (line without its newline) and appends the reply, newline included, to out
+		void execute(const char* line, size_t length, std::string& out);
+		bool isClosed() const; //True once Q has been received
+		//Back to no game and not closed. The board is kept for the next N of the same size if it has at most
+		//keepCells cells, otherwise it is freed.
+		void restart(long long keepCells = LLONG_MAX);
+
+	private:
+		std::unique_ptr<Board> board;
+		bool playing; //False until N, so a restarted protocol does not expose the previous game
+		bool closed;
+
+		void newGame(const char* p, const char* end, std::string& out);
+		void appendChanges(std::string& out) const;
+		void appendState(std::string& out) const;
+		char status() const;
+		char cellChar(int x, int y) const;
+};
+
+#endif
@@ -0,0 +1,285 @@
+#include "GameServer.h"
+#include "ThreadPool.h"
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+static const size_t readChunk = 4096; //Per read; bots send short commands, and thousands of sessions share memory
+static const size_t maxLine = 1 << 20; //A longer command closes the connection
+static const size_t outputLimit = 1 << 20; //Commands stop running while this much reply is waiting to be sent
+static const size_t keptInput = 16 * readChunk; //Command buffers above this are freed when the session is recycled
+static const size_t keptOutput = 1 << 20; //Reply buffers above this are freed when the session is recycled
+static const long long keptBoardCells = 1 << 20; //Boards above this are freed when the session is recycled
+
+struct GameServer::Watched {
+	int fd;
+	bool listener;
+	bool tcp;
+
+	Watched(int fd, bool listener, bool tcp) : fd(fd), listener(listener), tcp(tcp) {}
+};
+
+struct GameServer::Session : Watched {
+	std::vector<char> input;
+	size_t filled; //Bytes of input not yet run; whole commands only wait here while replies are backed up
+	std::string output;
+	size_t sent;
+	bool writing; //Replies are backed up: the session waits for EPOLLOUT and reads or runs nothing until they drain
+	GameProtocol protocol;
+
+	Session() : Watched(-1, false, false), filled(0), sent(0), writing(false) {}
+};
+
+//A worker's loop and the sessions it owns; only its own thread touches it
+struct GameServer::Worker {
+	int epollFd;
+	std::vector<std::unique_ptr<Session>> owned;
+	std::vector<Session*> idle; //Closed sessions kept for reuse
+
+	Worker() : epollFd(-1) {}
+};
+
+GameServer::GameServer(int workers) : tcpPort(0), sessions(0), commands(0)
+{
+	workerCount = workers > 0 ? workers : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+GameServer::~GameServer()
+{
+	for (auto& listener : listeners) ::close(listener->fd);
+	for (const std::string& path : unixPaths) unlink(path.c_str());
+	if (wakeFd >= 0) ::close(wakeFd);
+}
+
+int GameServer::getTcpPort() const { return tcpPort; }
+size_t GameServer::getSessionCount() const { return sessions.load(std::memory_order_relaxed); }
+unsigned long long GameServer::getCommandCount() const { return commands.load(std::memory_order_relaxed); }
+
+bool GameServer::addListener(int fd)
+{
+	if (listen(fd, SOMAXCONN) != 0) return false;
+	listeners.emplace_back(new Watched(fd, true, false));
+	return true;
+}
+
+bool GameServer::listenTcp(int port, const std::string& host)
+{
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(static_cast<uint16_t>(port));
+	if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) return false;
+
+	const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) return false;
+	const int one = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || !addListener(fd)) {
+		::close(fd);
+		return false;
+	}
+	listeners.back()->tcp = true;
+	socklen_t length = sizeof(address);
+	if (getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0) tcpPort = ntohs(address.sin_port);
+	return true;
+}
+
+bool GameServer::listenUnix(const std::string& path)
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	if (path.size() >= sizeof(address.sun_path)) return false;
+	address.sun_family = AF_UNIX;
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) return false;
+	unlink(path.c_str()); //A socket file left by an earlier run would fail the bind
+	if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || !addListener(fd)) {
+		::close(fd);
+		return false;
+	}
+	unixPaths.push_back(path);
+	return true;
+}
+
+void GameServer::stop()
+{
+	//The eventfd is never read, so it stays readable and every loop sees it
+	const uint64_t one = 1;
+	if (::write(wakeFd, &one, sizeof(one)) < 0) {}
+}
+
+void GameServer::run()
+{
+	ThreadPool pool(workerCount);
+	//Each loop only returns on stop(), so every index ends up on its own thread
+	pool.parallelFor(workerCount, [this](int worker) { serve(worker); });
+}
+
+void GameServer::serve(int)
+{
+	Worker worker;
+	worker.epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (worker.epollFd < 0) return;
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.ptr = nullptr;
+	epoll_ctl(worker.epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+	for (auto& listener : listeners) {
+		//Exclusive, so a new connection wakes one worker instead of all of them
+		event.events = EPOLLIN | EPOLLEXCLUSIVE;
+		event.data.ptr = listener.get();
+		epoll_ctl(worker.epollFd, EPOLL_CTL_ADD, listener->fd, &event);
+	}
+
+	epoll_event events[256];
+	bool running = true;
+	while (running) {
+		const int ready = epoll_wait(worker.epollFd, events, 256, -1);
+		if (ready < 0 && errno != EINTR) break;
+		for (int i = 0; i < ready; ++i) {
+			Watched* watched = static_cast<Watched*>(events[i].data.ptr);
+			if (!watched) {
+				running = false;
+			} else if (watched->listener) {
+				accept(worker, *watched);
+			} else {
+				Session* session = static_cast<Session*>(watched);
+				bool open = !(events[i].events & (EPOLLERR | EPOLLHUP));
+				if (open && (events[i].events & EPOLLOUT)) open = pump(worker, *session);
+				if (open && (events[i].events & (EPOLLIN | EPOLLRDHUP))) open = receive(worker, *session);
+				if (!open) close(worker, session);
+			}
+		}
+	}
+
+	for (auto& session : worker.owned) {
+		if (session->fd >= 0) close(worker, session.get());
+	}
+	::close(worker.epollFd);
+}
+
+void GameServer::accept(Worker& worker, const Watched& listener)
+{
+	//One connection per wakeup: the listener stays readable while more are queued, and the next one may
+	//wake a different worker, which spreads a burst of connections over the pool
+	const int fd = accept4(listener.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if (fd < 0) return;
+	if (listener.tcp) {
+		const int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	}
+
+	Session* session;
+	if (worker.idle.empty()) {
+		worker.owned.emplace_back(new Session());
+		session = worker.owned.back().get();
+	} else {
+		session = worker.idle.back();
+		worker.idle.pop_back();
+	}
+	session->fd = fd;
+	session->tcp = listener.tcp;
+
+	epoll_event event;
+	event.events = EPOLLIN | EPOLLRDHUP;
+	event.data.ptr = session;
+	sessions.fetch_add(1, std::memory_order_relaxed);
+	if (epoll_ctl(worker.epollFd, EPOLL_CTL_ADD, fd, &event) != 0) close(worker, session);
+}
+
+//One read per wakeup keeps a session that pipelines heavily from starving the others; level-triggered
+//epoll reports it again while it has more
+bool GameServer::receive(Worker& worker, Session& session)
+{
+	if (session.input.size() < session.filled + readChunk) session.input.resize(session.filled + readChunk);
+	ssize_t n;
+	do {
+		n = ::read(session.fd, session.input.data() + session.filled, session.input.size() - session.filled);
+	} while (n < 0 && errno == EINTR);
+	if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+	if (n == 0) return false;
+	session.filled += static_cast<size_t>(n);
+	return pump(worker, session);
+}
+
+//Runs buffered commands until their replies pass outputLimit, sends, and repeats while the socket keeps up.
+//Commands left over wait in input for EPOLLOUT, so a client that pipelines without reading holds at most
+//about one limit of replies (plus the last reply) on the server.
+bool GameServer::pump(Worker& worker, Session& session)
+{
+	for (;;) {
+		char* const data = session.input.data();
+		size_t start = 0;
+		unsigned long long ran = 0;
+		while (!session.protocol.isClosed() && session.output.size() - session.sent < outputLimit) {
+			const char* newline = static_cast<const char*>(std::memchr(data + start, '\n', session.filled - start));
+			if (!newline) break;
+			session.protocol.execute(data + start, static_cast<size_t>(newline - (data + start)), session.output);
+			start = static_cast<size_t>(newline - data) + 1;
+			++ran;
+		}
+		commands.fetch_add(ran, std::memory_order_relaxed);
+		std::memmove(data, data + start, session.filled - start);
+		session.filled -= start;
+
+		if (!send(worker, session) || session.protocol.isClosed()) return false;
+		if (session.writing) return true;
+		if (!std::memchr(data, '\n', session.filled)) return session.filled <= maxLine;
+	}
+}
+
+bool GameServer::send(Worker& worker, Session& session)
+{
+	while (session.sent < session.output.size()) {
+		const ssize_t n = ::send(session.fd, session.output.data() + session.sent, session.output.size() - session.sent, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+			return false;
+		}
+		session.sent += static_cast<size_t>(n);
+	}
+	const bool backedUp = session.sent < session.output.size();
+	if (!backedUp) {
+		session.output.clear();
+		session.sent = 0;
+	}
+	if (backedUp != session.writing) {
+		session.writing = backedUp;
+		epoll_event event;
+		event.events = backedUp ? EPOLLOUT : EPOLLIN | EPOLLRDHUP;
+		event.data.ptr = &session;
+		epoll_ctl(worker.epollFd, EPOLL_CTL_MOD, session.fd, &event);
+	}
+	return true;
+}
+
+void GameServer::close(Worker& worker, Session* session)
+{
+	::close(session->fd); //Also drops it from the epoll set
+	session->fd = -1;
+	session->filled = 0;
+	if (session->input.capacity() > keptInput) std::vector<char>().swap(session->input);
+	session->sent = 0;
+	session->writing = false;
+	if (session->output.capacity() > keptOutput) std::string().swap(session->output);
+	else session->output.clear();
+	session->protocol.restart(keptBoardCells);
+	worker.idle.push_back(session);
+	sessions.fetch_sub(1, std::memory_order_relaxed);
+}
+
+//End of GameServer.cpp
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include "GameProtocol.h"
+
+//Hosts many GameProtocol sessions over TCP and Unix sockets (Linux only: it is built on epoll). Each worker
+//thread runs its own epoll loop; the listeners are shared with EPOLLEXCLUSIVE, and a connection stays with
+//the worker that accepted it, so sessions are never locked. Closed sessions go back to their worker's pool
+//with their buffers and board (each only up to a size), so a new connection usually reuses them instead of
+//allocating. A session stops running commands while about 1 MB of its replies is unsent.
+class GameServer {
+	public:
+		explicit GameServer(int workers = 0); //0 = one worker per hardware core
+		~GameServer();
+
+		//Listeners must be added before run(); false if the socket could not be bound
+		bool listenTcp(int port, const std::string& host = "127.0.0.1");
+		bool listenUnix(const std::string& path);
+		int getTcpPort() const; //Port actually bound, for listenTcp(0)
+
+		void run(); //Serves until stop(); the calling thread is one of the workers
+		void stop(); //Safe from any thread, including a signal handler
+
+		size_t getSessionCount() const; //Connections currently open
+		unsigned long long getCommandCount() const; //Commands answered since construction
+
+	private:
+		struct Watched;
+		struct Session;
+		struct Worker;
+
+		int workerCount;
+		int wakeFd; //eventfd that ends every worker's loop once written
+		int tcpPort;
+		std::vector<std::unique_ptr<Watched>> listeners;
+		std::vector<std::string> unixPaths;
+		std::atomic<size_t> sessions;
+		std::atomic<unsigned long long> commands;
+
+		bool addListener(int fd);
+		void serve(int worker);
+		void accept(Worker& worker, const Watched& listener);
+		bool receive(Worker& worker, Session& session);
+		bool pump(Worker& worker, Session& session);
+		bool send(Worker& worker, Session& session);
+		void close(Worker& worker, Session* session);
+};
+
+#endif
@@ -1,25 +1,36 @@
 #include "GameWindow.h"
 #include "Settings.h"
 #include "Board.h"
+#include "BoardView.h"
+#include "BoardSnapshot.h"
+#include <cstdio>
 #include <sstream>
 #include <string>
 #include <FL/fl_ask.H>
 #include <iomanip>
+#include <algorithm>
 #include <FL/fl_draw.H>
 #include <FL/Fl_Image.H>
 
+//Window size for a board at 30 px per cell, limited to the screen; bigger boards scroll and zoom in the view
+static int initialWindowWidth(int boardWidth)
+{
+	return std::max(9 * 30, std::min(boardWidth * 30, Fl::w() - 40));
+}
+static int initialWindowHeight(int boardHeight, int topControlsHeight)
+{
+	return std::min(boardHeight * 30, Fl::h() - 80 - topControlsHeight) + topControlsHeight;
+}
+
 //Initialize GameWindow with board dimensions and mine count
 
-GameWindow::GameWindow(int width, int height, int mineCount)
-: Fl_Window(width * 30, (height * 30)+60, "Minesweeper"), boardWidth(width), boardHeight(height), gameBoard(width, height, mineCount)
+GameWindow::GameWindow(int width, int height, int mineCount, bool noGuess)
+: Fl_Window(initialWindowWidth(width), initialWindowHeight(height, topControlsHeight), "Minesweeper"), boardWidth(width), boardHeight(height), gameBoard(width, height, mineCount)
 {
 	begin();
-	int window = width * 30;
+	int window = w();
 	int center = window / 2;
 
-	// Increase top area so the board moves down more to allow space for widgets
-	const int topControlsHeight = 120; 
-
 	//Timer Initialization
 	secondsElapsed = 0;
 	timerRunning = false;
@@ -50,6 +61,10 @@ GameWindow::GameWindow(int width, int height, int mineCount)
 	// Menu/Newgame Button
 	settingsButton = new Fl_Button(center + 50, 10 + 12, 80, 30, "Settings");
 	settingsButton->callback(settings_cb, this);
+
+	//Replay Button, under Reset
+	replayButton = new Fl_Button(center - 45, 10 + 12 + 36, 80, 30, "Replay");
+	replayButton->callback(replay_cb, this);
 	
 	//Timer Label and Output
 	// compute positions relative to mineCounterOutput placement to ensure they share X axis
@@ -70,16 +85,21 @@ GameWindow::GameWindow(int width, int height, int mineCount)
 	timerOutput->textsize(18);
 	timerOutput->value("000");
 
-	//Create buttons for each cell in the board (moved down by topControlsHeight)
-	for (int y = 0; y < height; ++y) {
-		for (int x = 0; x < width; ++x) {
-			Fl_Button* btn = new Fl_Button(x * 30, (y * 30) + topControlsHeight, 30, 30);
-			btn->callback(buttonCallback, this);
-			// keep images/labels centered in the cell
-			btn->align(FL_ALIGN_INSIDE | FL_ALIGN_CENTER);
-			cellButtons.push_back(btn);
-		}
-	}
+	//One viewport draws the visible part of the grid (moved down by topControlsHeight).
+	//Start as close to 30 px cells as fits, but never below the size that still shows numbers.
+	boardView = new BoardView(0, topControlsHeight, w(), h() - topControlsHeight, gameBoard);
+	int fit = std::min(w() / width, (h() - topControlsHeight) / height);
+	boardView->setCellSize(std::max(static_cast<int>(BoardView::detailCellSize), std::min(30, fit)));
+	boardView->setImages(imgMine, imgFlag);
+	boardView->callback(boardCallback, this);
+	resizable(boardView);
+	callback(close_cb, this);
+	gameBoard.setRecorder(&actionLog);
+	gameBoard.addListener(this);
+	gameBoard.setUndoLimit(1000);
+	gameBoard.setPrefetch(true); //Reset swaps in a layout made while the previous game was played
+	//Above the generator's size limit the game is played on ordinary layouts
+	if (noGuess && width * height <= NoGuessGenerator::maxCells) generator.reset(new NoGuessGenerator());
 
 	// Ensure top widgets positioned in case window() differs from computed 'window'
 	layoutTopControls(window);
@@ -90,39 +110,24 @@ GameWindow::GameWindow(int width, int height, int mineCount)
 
 //Destructor
 GameWindow::~GameWindow() {
-	//Buttons are automatically deleted by FLTK when the window is destroyed
+	//Widgets are automatically deleted by FLTK when the window is destroyed
 
 	delete imgFlag;
 	delete imgMine;
 
 }
 
-//Static callback for button clicks
-void GameWindow::buttonCallback(Fl_Widget* widget, void* data) {
+//Static callback for clicks on the board; the view already mapped the click to a cell
+void GameWindow::boardCallback(Fl_Widget* widget, void* data) {
 	//Retrieve the current GameWindow instance from user data
 	GameWindow* gw = static_cast<GameWindow*>(data);
-	Fl_Button* btn = static_cast<Fl_Button*>(widget);
-	int index = -1;
-
+	BoardView* view = static_cast<BoardView*>(widget);
+	int x = view->eventCellX();
+	int y = view->eventCellY();
 
-	//Find the index of the clicked button
-	for (size_t i = 0; i < gw->cellButtons.size(); ++i) {
-		if (gw->cellButtons[i] == btn) {
-			index = static_cast<int>(i);
-			break;
-		}
-	}
-
-	//Case: Button not found
-	if (index == -1) return; 
-
-	//Calculate cell coordinates from index
-	int x = index % gw->boardWidth;
-	int y = index / gw->boardWidth;
-	
 	//Get cell state to see if its revealed or hidden
-	const Cell& cell = gw->gameBoard.getCell(x, y);
-	int button = Fl::event_button();
+	const Cell cell = gw->gameBoard.getCell(x, y);
+	int button = view->eventButton();
 
 
 	//Start Timer on first valid click on board
@@ -146,6 +151,7 @@ void GameWindow::buttonCallback(Fl_Widget* widget, void* data) {
 		if(button == FL_LEFT_MOUSE) {
 			// Prevent revealing flagged cells at GUI level as well
 			if (!cell.isFlagged) {
+				if (gw->generator && gw->gameBoard.getCellsRevealed() == 0) gw->generateNoGuess(x, y);
 				gw->gameBoard.revealCell(x, y);
 			}
 		} 
@@ -153,16 +159,28 @@ void GameWindow::buttonCallback(Fl_Widget* widget, void* data) {
 			gw->gameBoard.toggleFlag(x, y);
 		}
 	}
-	//Update the GUI after the action
-	gw->updateGUI();
-
-	// Check win first, then loss.
-	// Board sets both isGameWon and isGameOver on a win, so checking isGameOver first produced "You Lose!" even when won.
-	if (gw->gameBoard.getIsGameWon()) {
-		gw->endGame(true);
-	} else if (gw->gameBoard.getIsGameOver()) {
-		gw->endGame(false, x, y);
+	//The board reports what changed through onBoardEvents
+}
+
+//The layout depends on where the first click lands, so no-guess games are chosen here rather than at reset.
+//Candidates are solved on every core; an expert board needs a few dozen at most, well under a frame.
+void GameWindow::generateNoGuess(int x, int y) {
+	const Board& board = gameBoard;
+	const int cells = board.getWidth() * board.getHeight();
+	//Each candidate is a full solve, so big boards get fewer tries before falling back to the current layout
+	const int budget = std::max(16, std::min(20000, 50000000 / std::max(cells, 1)));
+	uint64_t seed;
+	if (!generator->findSeed(board.getWidth(), board.getHeight(), board.getMineCount(), x, y, board.getSeed(), seed, budget)) return;
+
+	//Reseeding clears the board, so flags placed before the first click are put back
+	std::vector<std::pair<int, int>> flags;
+	for (int cy = 0; cy < board.getHeight() && static_cast<int>(flags.size()) < board.getFlagsPlaced(); ++cy) {
+		for (int cx = 0; cx < board.getWidth(); ++cx) {
+			if (board.getCell(cx, cy).isFlagged) flags.emplace_back(cx, cy);
+		}
 	}
+	gameBoard.resetBoard(seed);
+	for (const auto& flag : flags) gameBoard.toggleFlag(flag.first, flag.second);
 }
 
 //callback for newgame button
@@ -175,36 +193,111 @@ void GameWindow::new_game(Fl_Widget* widget, void* data){
 	gw->secondsElapsed = 0;
 	gw->timerOutput->value("000");
 
+	//Playback detaches the recorder; a new game always records again
+	gw->stopPlayback();
+	gw->gameBoard.setRecorder(&gw->actionLog);
 	gw->gameBoard.resetBoard();
 
-	// Use direct indexing into cellButtons instead of calling a non-existent getButtonAt()
-	for(int y = 0; y < gw->boardHeight; ++y){
-		for(int x = 0; x < gw->boardWidth; ++x){
-			int idx = y * gw->boardWidth + x;
-			// safety check
-			if (idx < 0 || idx >= static_cast<int>(gw->cellButtons.size())) continue;
-			Fl_Button* btn = gw->cellButtons[idx];
-			if (!btn) continue;
-			btn->activate();
-			btn->copy_label("");
-			btn->image(nullptr);
-			btn->labelcolor(FL_BLACK);
-			btn->color(FL_BACKGROUND_COLOR);
-			btn->box(FL_UP_BOX);
-			btn->redraw();
-		}
-	}
-	//Update mine counter
-	gw->mineCounterOutput->value(std::to_string(gw->gameBoard.getMineCount()).c_str());
+	gw->boardView->clearReveal();
+	gw->boardView->activate();
 	gw->redraw(); //Helps redraw window after resetting to prevent Win/Loss message
 }
 
+const char* const GameWindow::saveFileName = "minesweeper.sav";
+
+bool GameWindow::saveGame(const std::string& path) {
+	SnapshotInfo info;
+	info.secondsElapsed = secondsElapsed;
+	info.timerRunning = timerRunning;
+	return BoardSnapshot::save(path, gameBoard, info);
+}
+
+bool GameWindow::resumeGame(const BoardSnapshot& snapshot) {
+	if (!snapshot.restore(gameBoard)) return false;
+	//A log replays from the seed, which cannot reach a restored position; record again from the next Reset
+	gameBoard.setRecorder(nullptr);
+	actionLog.start(gameBoard.getWidth(), gameBoard.getHeight(), gameBoard.getMineCount(), gameBoard.getSeed(), gameBoard.getSafeRadius());
+
+	const SnapshotInfo info = snapshot.getInfo();
+	secondsElapsed = info.secondsElapsed;
+	std::stringstream ss;
+	ss << std::setw(3) << std::setfill('0') << secondsElapsed;
+	timerOutput->value(ss.str().c_str());
+	Fl::remove_timeout(timer_cb, this);
+	timerRunning = info.timerRunning;
+	if (timerRunning) Fl::add_timeout(1.0, timer_cb, this);
+
+	return true;
+}
+
+//Closing keeps a game in progress on disk; a finished or untouched game leaves no save behind
+void GameWindow::close_cb(Fl_Widget* widget, void* data) {
+	GameWindow* gw = static_cast<GameWindow*>(data);
+	const bool started = gw->gameBoard.getCellsRevealed() > 0 || gw->gameBoard.getFlagsPlaced() > 0;
+	if (started && !gw->gameBoard.getIsGameOver()) {
+		gw->saveGame(saveFileName);
+	} else {
+		std::remove(saveFileName);
+	}
+
+	gw->timerRunning = false;
+	Fl::remove_timeout(timer_cb, gw);
+	gw->stopPlayback();
+	gw->hide();
+}
+
+//Replays the recorded game onto the board at its original pace. The board stays read-only until Reset,
+//which also starts recording again.
+void GameWindow::replay_cb(Fl_Widget* widget, void* data) {
+	GameWindow* gw = static_cast<GameWindow*>(data);
+	if (gw->actionLog.size() == 0 && !gw->playback) return;
+
+	gw->timerRunning = false;
+	Fl::remove_timeout(timer_cb, gw);
+	Fl::remove_timeout(playback_cb, gw);
+	if (!gw->playback) {
+		gw->playbackLog = gw->actionLog;
+		gw->gameBoard.setRecorder(nullptr);
+		gw->playback.reset(new Replay(gw->playbackLog, gw->gameBoard));
+	} else {
+		gw->playback->seek(0);
+	}
+
+	gw->boardView->clearReveal();
+	gw->boardView->deactivate();
+	gw->playbackStart = std::chrono::steady_clock::now();
+	Fl::add_timeout(1.0 / 30.0, playback_cb, gw);
+}
+
+void GameWindow::playback_cb(void* data) {
+	GameWindow* gw = static_cast<GameWindow*>(data);
+	if (!gw->playback) return;
+
+	const auto elapsed = std::chrono::steady_clock::now() - gw->playbackStart;
+	gw->playback->advanceTo(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+
+	std::stringstream ss;
+	ss << std::setw(3) << std::setfill('0') << gw->playback->getTimeMs() / 1000;
+	gw->timerOutput->value(ss.str().c_str());
+
+	//Cells and counters were repainted by onBoardEvents as each action was applied
+	if (!gw->playback->atEnd()) {
+		Fl::repeat_timeout(1.0 / 30.0, playback_cb, gw);
+	}
+}
+
+void GameWindow::stopPlayback() {
+	Fl::remove_timeout(playback_cb, this);
+	playback.reset();
+}
+
 //Callback for "Menu" (Closes and opens Settings Window)
 void GameWindow::settings_cb(Fl_Widget* widget, void* data) {
 	GameWindow* gw = static_cast<GameWindow*>(data);
 
 	gw->timerRunning = false;
 	Fl::remove_timeout(timer_cb, gw);
+	gw->stopPlayback();
 
 	gw->hide(); //Hide current game window
 	SettingsWindow* settings = new SettingsWindow(600, 400, "Minesweeper Settings");
@@ -226,74 +319,66 @@ void GameWindow::timer_cb(void* data) {
 	Fl::repeat_timeout(1.0, timer_cb, gw);
 }
 
-//Update the GUI based on the board state
-void GameWindow::updateGUI() {
-
-	//Update conter based on mines and flags placed
-	int remaining = gameBoard.getMineCount() - gameBoard.getFlagsPlaced();
-	mineCounterOutput->value(std::to_string(remaining).c_str());
-
-	//Iterate through each cell to update state of each button
-	for (int i = 0; i < boardWidth * boardHeight; ++i)
-	{
-		//Calculate cell coordinates
-		int x = i % boardWidth;
-		int y = i / boardWidth;
-		const Cell& c = gameBoard.getCell(x, y);
-		//Update appearance based on cell state
-		Fl_Button* btn = cellButtons[i];
-
-		// If the cell is revealed, show its content and disable the button.
-		if (c.isRevealed) {
-			//To ensure no flag/mine image is shown on revealed cells
-			if(btn->image() && !c.isMine) btn->image(nullptr);
-
-			if (btn->box() != FL_FLAT_BOX) btn->box(FL_FLAT_BOX);
-			if (c.isMine) {
-				if (imgMine) {
-					btn->image(imgMine);
-					btn->copy_label(""); // No text needed if image exists
+//Update the GUI based on the board state.
+//Only the cells the last action changed are touched, so cost follows the size of the change, not the board.
+void GameWindow::onBoardEvents(const Board& board, const BoardEvent* events, size_t count) {
+	const std::vector<int>& changed = board.getChangedCells();
+	bool won = false;
+	bool lost = false;
+	bool resumed = false;
+	int explodeX = -1;
+	int explodeY = -1;
+	for (size_t i = 0; i < count; ++i) {
+		const BoardEvent& event = events[i];
+		switch (event.type) {
+			case EVENT_CELLS_REVEALED:
+			case EVENT_CELLS_RESTORED:
+			case EVENT_FLAG_TOGGLED:
+				boardView->damageCells(changed.data() + event.first, static_cast<size_t>(event.count));
+				break;
+			case EVENT_MINE_HIT:
+				//A chord can uncover several mines; the first one is shown as the explosion
+				if (!lost) {
+					explodeX = event.x;
+					explodeY = event.y;
 				}
-				else {
-					btn->copy_label("*");
-					btn->labelcolor(FL_RED);
-				}
-			} else if (c.adjacentMines > 0) {
-				std::string s = std::to_string(c.adjacentMines);
-				btn->copy_label(s.c_str()); //Show adjacent mine count
-				switch (c.adjacentMines) {
-					case 1: btn->labelcolor(FL_BLUE); break;
-					case 2: btn->labelcolor(FL_GREEN); break;
-					case 3: btn->labelcolor(FL_RED); break;
-					default: btn->labelcolor(FL_DARK_BLUE); break;
-				}
-			} else {
-				btn->copy_label(""); //Empty for no adjacent mines
-			}
+				lost = true;
+				break;
+			case EVENT_GAME_WON:
+				won = true;
+				break;
+			case EVENT_GAME_RESUMED:
+				resumed = true;
+				break;
+			case EVENT_BOARD_RESET: //A restored board can also have a different mine count
+				boardView->redraw();
+				mineCounterOutput->value(std::to_string(board.getMineCount() - board.getFlagsPlaced()).c_str());
+				break;
+			case EVENT_COUNTERS_CHANGED:
+				mineCounterOutput->value(std::to_string(board.getMineCount() - board.getFlagsPlaced()).c_str());
+				break;
 		}
-		else {
-			// Unrevealed cells: show flag if flagged, otherwise blank
-			if (btn->box() != FL_UP_BOX) btn->box(FL_UP_BOX);
-			if (!btn->active()) btn->activate();
-			if (c.isFlagged) {
-				// USE IMAGE FOR FLAG
-				if (imgFlag) {
-					btn->image(imgFlag);
-					btn->copy_label("");
-				}
-				else {
-					btn->copy_label("F");
-					btn->labelcolor(FL_RED);
-				}
-			} else {
-				 //clear any previous flag image when flag removed
-				if (btn->image()) btn->image(static_cast<Fl_Image*>(nullptr));
-				btn->activate();
-				btn->copy_label("");
-				btn->labelcolor(FL_BLACK); // reset any leftover label color
-			}
+	}
+
+	//Playback only shows the end of the game; the timer and message belong to real play
+	if (playback) {
+		if (won || lost) boardView->revealMines(explodeX, explodeY);
+		return;
+	}
+	if (resumed) {
+		//Taking back the last move of a finished game lets play continue
+		boardView->clearReveal();
+		boardView->activate();
+		if (!timerRunning && board.getCellsRevealed() > 0) {
+			timerRunning = true;
+			Fl::add_timeout(1.0, timer_cb, this);
 		}
-		btn->redraw(); //Redraw button to reflect changes
+	}
+	// Check win first: Board sets both isGameWon and isGameOver on a win
+	if (won) {
+		endGame(true);
+	} else if (lost) {
+		endGame(false, explodeX, explodeY);
 	}
 }
 
@@ -304,25 +389,9 @@ void GameWindow::endGame(bool won, int explodeX, int explodeY) {
 	timerRunning = false;
 	Fl::remove_timeout(timer_cb, this);
 
-	for (int i = 0; i < boardWidth * boardHeight; ++i) {
-		int x = i % boardWidth;
-		int y = i / boardWidth;
-		const Cell& c = gameBoard.getCell(x, y);
-		Fl_Button* btn = cellButtons[i];
-		if (c.isMine) {
-			// Show mine image
-			if (imgMine) btn->image(imgMine);
-			else {
-				btn->copy_label("*");
-				btn->labelcolor(FL_RED);
-			}
-			if (x == explodeX && y == explodeY) {
-				btn->color(FL_RED); // Red background for explosion
-			}
-
-		}
-		btn->deactivate();
-	}
+	//The view draws every mine from here on and ignores further clicks
+	boardView->revealMines(explodeX, explodeY);
+	boardView->deactivate();
 	this->redraw();
 
 	// Create a centered message box inside this window to show result
@@ -361,13 +430,45 @@ void GameWindow::layoutTopControls(int windowWidth) {
 
 	// Settings (center right)
 	if (settingsButton) settingsButton->resize(center + 50, 10 + 12, 80, 30);
+
+	// Replay (under Reset)
+	if (replayButton) replayButton->resize(center - 45, 10 + 12 + 36, 80, 30);
+}
+
+// The viewport fills the space below the top controls; zoom and scroll position are kept
+void GameWindow::layoutGrid(int windowWidth, int windowHeight) {
+	boardView->resize(0, topControlsHeight, windowWidth, windowHeight - topControlsHeight);
 }
 
 // Ensure top controls are repositioned when window is resized
 void GameWindow::resize(int X, int Y, int W, int H) {
 	Fl_Window::resize(X, Y, W, H);
 	layoutTopControls(W);
+	layoutGrid(W, H);
 	redraw();	
 }
 
+int GameWindow::handle(int event) {
+	//Keys the board view does not use come back to the window as shortcuts
+	if (event == FL_SHORTCUT && (Fl::event_state() & FL_CTRL)) {
+		const bool shift = (Fl::event_state() & FL_SHIFT) != 0;
+		if (Fl::event_key() == 'z') {
+			stepHistory(shift);
+			return 1;
+		}
+		if (Fl::event_key() == 'y') {
+			stepHistory(true);
+			return 1;
+		}
+	}
+	return Fl_Window::handle(event);
+}
+
+//Undoes (or redoes) one move; only the cells that move touched are repainted
+void GameWindow::stepHistory(bool forward) {
+	if (playback) return;
+	if (forward) gameBoard.redo();
+	else gameBoard.undo();
+}
+
 //End of GameWindow.cpp
\ No newline at end of file
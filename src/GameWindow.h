@@ -7,30 +7,62 @@
 #include <FL/Fl_Box.H>
 #include <FL/Fl_Button.H>
 #include <FL/Fl_Output.H>
+#include <FL/Fl_PNG_Image.H>
 #include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
 #include "Board.h"
+#include "ActionLog.h"
+#include "Replay.h"
+#include "NoGuessGenerator.h"
 
-class GameWindow : public Fl_Window {
+class BoardView;
+class BoardSnapshot;
+
+class GameWindow : public Fl_Window, private BoardListener {
 	public:
-		//Constructor to initialize the game window with given dimensions and mine count
-		GameWindow(int width, int height, int mineCount);
+		//Constructor to initialize the game window with given dimensions and mine count;
+		//noGuess lays out every game so it can be won by logic alone
+		GameWindow(int width, int height, int mineCount, bool noGuess = false);
 
 		//Destructor Function
 		~GameWindow();
 
+		//An unfinished game is written here when the window closes and offered again from Settings
+		static const char* const saveFileName;
+		bool saveGame(const std::string& path);
+		//Continues a saved game, timer included; the window must have the snapshot's board size
+		bool resumeGame(const BoardSnapshot& snapshot);
+
 
 	private:
 		Board gameBoard; //Model to track states of all cells in board
-		std::vector<Fl_Button*> cellButtons; //Vector to hold buttons representing each cell
+		BoardView* boardView; //Single widget that draws the grid and maps clicks to cells
+		static const int topControlsHeight = 120; //Space above the grid for counter, timer and buttons
 		
 		//Callback functions for button clicks, game reset, settigns, and timer
-		static void buttonCallback(Fl_Widget* widget, void* data); //Static callback function for button clicks
+		static void boardCallback(Fl_Widget* widget, void* data); //Static callback function for clicks on the board
 		static void settings_cb(Fl_Widget* widget, void* data); //Static callback for settings button
 		static void new_game(Fl_Widget* widget, void* data); //Static callback for new game button
 		static void timer_cb(void* data); //Static callback for timer updates
+		static void close_cb(Fl_Widget* widget, void* data); //Saves an unfinished game when the window closes
+		static void replay_cb(Fl_Widget* widget, void* data); //Plays the current game back from the start
+		static void playback_cb(void* data); //Advances playback to the wall-clock time since it started
+
+		ActionLog actionLog; //Every move of the current game, recorded by gameBoard
+		ActionLog playbackLog; //Copy being played back, so playback never records over itself
+		std::unique_ptr<Replay> playback;
+		std::chrono::steady_clock::time_point playbackStart;
+		void stopPlayback();
+
+		//Set for no-guess games: each is re-seeded on its first click to a layout the solver clears
+		std::unique_ptr<NoGuessGenerator> generator;
+		void generateNoGuess(int x, int y);
 		
 		
-		void updateGUI(); //Function to update the GUI based on the board state
+		//Repaints what each move changed and ends or resumes the game; the board is never rescanned
+		void onBoardEvents(const Board& board, const BoardEvent* events, size_t count) override;
 		void endGame(bool won, int explodeX = -1, int explodeY = -1); //Function to handle end of game scenarios
 		int boardWidth; //Width of the board in cells
 		int boardHeight; //Height of the board in cells
@@ -47,15 +79,16 @@ class GameWindow : public Fl_Window {
 
 		Fl_Button* resetButton; //Button to reset the game
 		Fl_Button* settingsButton; //Button to toggle flag mode
+		Fl_Button* replayButton; //Button to watch the current game again in real time
 
 		// Layout helpers
 		void layoutTopControls(int windowWidth);
 		void layoutGrid(int windowWidth, int windowHeight);
 		// Keep top controls repositioned when window is resized
 		void resize(int X, int Y, int W, int H) override;
-
-		Fl_Button* createCellButton(int x, int y); //Function to create a button for a cell at (x, y)
-		Fl_Button* getButtonAt(int x, int y); //Function to get the button at cell (x, y)
+		// Ctrl+Z undoes the last move, Ctrl+Y or Ctrl+Shift+Z redoes it
+		int handle(int event) override;
+		void stepHistory(bool forward);
 
 		//Store Pointers to Images for Mines, Flags
 		Fl_PNG_Image* imgMine;
@@ -0,0 +1,250 @@
+#include "InfiniteBoard.h"
+#include "Random.h"
+#include <algorithm>
+#include <stdexcept>
+
+size_t InfiniteBoard::ChunkKeyHash::operator()(const ChunkKey& key) const
+{
+	return static_cast<size_t>(hashSeed(0, static_cast<uint64_t>(key.x), static_cast<uint64_t>(key.y)));
+}
+
+InfiniteBoard::InfiniteBoard(double density, uint64_t seed, size_t maxCachedChunks)
+{
+	if (!(density >= 0.15 && density < 1.0)) {
+		throw std::invalid_argument("Mine density must be in [0.15, 1)");
+	}
+	this->density = density;
+	this->mineThreshold = static_cast<uint64_t>(density * 18446744073709551616.0);
+	//A flood holds on to its current chunk while neighbours load, so keep a few chunks at least
+	this->maxCachedChunks = std::max<size_t>(maxCachedChunks, 16);
+	resetBoard(seed);
+}
+
+double InfiniteBoard::getDensity() const { return density; }
+uint64_t InfiniteBoard::getSeed() const { return seed; }
+bool InfiniteBoard::getIsGameOver() const { return isGameOver; }
+long long InfiniteBoard::getCellsRevealed() const { return cellsRevealed; }
+long long InfiniteBoard::getFlagsPlaced() const { return flagsPlaced; }
+size_t InfiniteBoard::getCachedChunkCount() const { return cache.size(); }
+size_t InfiniteBoard::getSavedChunkCount() const { return saved.size(); }
+
+void InfiniteBoard::resetBoard(uint64_t seed)
+{
+	this->seed = seed;
+	lru.clear();
+	cache.clear();
+	saved.clear();
+	lastChunk = nullptr;
+	firstClickHandled = false;
+	firstX = 0;
+	firstY = 0;
+	isGameOver = false;
+	cellsRevealed = 0;
+	flagsPlaced = 0;
+}
+
+//Pure function of the seed and the coordinates, apart from the 3x3 kept clear around the first click
+bool InfiniteBoard::mineAt(long long x, long long y) const
+{
+	if (firstClickHandled && x >= firstX - 1 && x <= firstX + 1 && y >= firstY - 1 && y <= firstY + 1) {
+		return false;
+	}
+	const uint64_t chunkSeed = hashSeed(seed, static_cast<uint64_t>(chunkOf(x)), static_cast<uint64_t>(chunkOf(y)));
+	return hashSeed(chunkSeed, static_cast<uint64_t>(localOf(y) * chunkSize + localOf(x)), 0) < mineThreshold;
+}
+
+int InfiniteBoard::countAt(long long x, long long y) const
+{
+	int count = 0;
+	for (long long ny = y - 1; ny <= y + 1; ++ny) {
+		for (long long nx = x - 1; nx <= x + 1; ++nx) {
+			if ((nx != x || ny != y) && mineAt(nx, ny)) ++count;
+		}
+	}
+	return count;
+}
+
+//Returns the cached chunk, regenerating it (and replaying its saved bitmap) when it is not in the cache
+InfiniteBoard::Chunk& InfiniteBoard::loadChunk(const ChunkKey& key)
+{
+	auto found = cache.find(key);
+	if (found != cache.end()) {
+		lru.splice(lru.begin(), lru, found->second);
+		return *found->second;
+	}
+
+	if (cache.size() >= maxCachedChunks) evictChunk();
+	lru.emplace_front();
+	Chunk& chunk = lru.front();
+	chunk.key = key;
+	cache[key] = lru.begin();
+
+	//Mines of the chunk plus the one-cell ring around it, then counts from the padded grid
+	const int padded = chunkSize + 2;
+	uint8_t mines[padded * padded];
+	const long long originX = key.x * chunkSize;
+	const long long originY = key.y * chunkSize;
+	for (int ly = -1; ly <= chunkSize; ++ly) {
+		for (int lx = -1; lx <= chunkSize; ++lx) {
+			mines[(ly + 1) * padded + lx + 1] = mineAt(originX + lx, originY + ly) ? 1 : 0;
+		}
+	}
+	for (int ly = 0; ly < chunkSize; ++ly) {
+		const uint8_t* above = &mines[ly * padded + 1];
+		const uint8_t* here = above + padded;
+		const uint8_t* below = here + padded;
+		uint8_t* out = &chunk.cells[ly * chunkSize];
+		for (int lx = 0; lx < chunkSize; ++lx) {
+			const int count = above[lx - 1] + above[lx] + above[lx + 1] + here[lx - 1] + here[lx + 1]
+				+ below[lx - 1] + below[lx] + below[lx + 1];
+			out[lx] = static_cast<uint8_t>((here[lx] ? CELL_MINE : 0) | count);
+		}
+	}
+
+	auto replay = saved.find(key);
+	if (replay != saved.end()) {
+		for (int ly = 0; ly < chunkSize; ++ly) {
+			for (int lx = 0; lx < chunkSize; ++lx) {
+				if ((replay->second.revealed[ly] >> lx) & 1) chunk.cells[ly * chunkSize + lx] |= CELL_REVEALED;
+				if ((replay->second.flagged[ly] >> lx) & 1) chunk.cells[ly * chunkSize + lx] |= CELL_FLAGGED;
+			}
+		}
+		saved.erase(replay);
+	}
+	return chunk;
+}
+
+//Drops the least recently used chunk, keeping its reveal/flag state if it has any
+void InfiniteBoard::evictChunk()
+{
+	Chunk& victim = lru.back();
+	SavedChunk bits;
+	bool played = false;
+	for (int ly = 0; ly < chunkSize; ++ly) {
+		uint64_t revealed = 0;
+		uint64_t flagged = 0;
+		for (int lx = 0; lx < chunkSize; ++lx) {
+			const uint8_t c = victim.cells[ly * chunkSize + lx];
+			revealed |= static_cast<uint64_t>((c & CELL_REVEALED) != 0) << lx;
+			flagged |= static_cast<uint64_t>((c & CELL_FLAGGED) != 0) << lx;
+		}
+		bits.revealed[ly] = revealed;
+		bits.flagged[ly] = flagged;
+		played |= (revealed | flagged) != 0;
+	}
+	if (played) saved[victim.key] = bits;
+
+	if (lastChunk == &victim) lastChunk = nullptr;
+	cache.erase(victim.key);
+	lru.pop_back();
+}
+
+//The returned reference stays valid until the next chunk is loaded
+uint8_t& InfiniteBoard::cellAt(long long x, long long y)
+{
+	const ChunkKey key = { chunkOf(x), chunkOf(y) };
+	if (!lastChunk || !(lastChunk->key == key)) lastChunk = &loadChunk(key);
+	return lastChunk->cells[localOf(y) * chunkSize + localOf(x)];
+}
+
+Cell InfiniteBoard::getCell(long long x, long long y) const
+{
+	const ChunkKey key = { chunkOf(x), chunkOf(y) };
+	const int local = localOf(y) * chunkSize + localOf(x);
+	auto found = cache.find(key);
+	if (found != cache.end()) return Cell(found->second->cells[local]);
+
+	uint8_t bits = static_cast<uint8_t>((mineAt(x, y) ? CELL_MINE : 0) | countAt(x, y));
+	auto replay = saved.find(key);
+	if (replay != saved.end()) {
+		if ((replay->second.revealed[localOf(y)] >> localOf(x)) & 1) bits |= CELL_REVEALED;
+		if ((replay->second.flagged[localOf(y)] >> localOf(x)) & 1) bits |= CELL_FLAGGED;
+	}
+	return Cell(bits);
+}
+
+void InfiniteBoard::revealCell(long long x, long long y)
+{
+	if (isGameOver) return;
+	if (!firstClickHandled) {
+		//The safe zone changes counts around it, so chunks loaded for early flags are rebuilt
+		while (!lru.empty()) evictChunk();
+		firstX = x;
+		firstY = y;
+		firstClickHandled = true;
+	}
+	floodReveal(x, y);
+}
+
+//Same worklist flood as Board; crossing into another chunk just loads (or rebuilds) that chunk
+void InfiniteBoard::floodReveal(long long x, long long y)
+{
+	uint8_t& start = cellAt(x, y);
+	if (start & (CELL_REVEALED | CELL_FLAGGED)) {
+		return;
+	}
+	start |= CELL_REVEALED;
+	++cellsRevealed;
+	if (start & CELL_MINE) {
+		isGameOver = true;
+		return;
+	}
+
+	revealStack.clear();
+	revealStack.push_back({ x, y });
+	while (!revealStack.empty()) {
+		const Coord current = revealStack.back();
+		revealStack.pop_back();
+		if (cellAt(current.x, current.y) & CELL_COUNT) continue;
+
+		for (long long ny = current.y - 1; ny <= current.y + 1; ++ny) {
+			for (long long nx = current.x - 1; nx <= current.x + 1; ++nx) {
+				uint8_t& next = cellAt(nx, ny);
+				if (next & (CELL_REVEALED | CELL_FLAGGED)) continue;
+				next |= CELL_REVEALED;
+				++cellsRevealed;
+				revealStack.push_back({ nx, ny });
+			}
+		}
+	}
+}
+
+void InfiniteBoard::toggleFlag(long long x, long long y)
+{
+	if (isGameOver) return;
+	uint8_t& c = cellAt(x, y);
+	if (c & CELL_REVEALED) {
+		return;
+	}
+	c ^= CELL_FLAGGED;
+	if (c & CELL_FLAGGED) {
+		flagsPlaced++;
+	} else {
+		flagsPlaced--;
+	}
+}
+
+void InfiniteBoard::chordCell(long long x, long long y)
+{
+	if (isGameOver) return;
+	const uint8_t current = cellAt(x, y);
+	if (!(current & CELL_REVEALED) || (current & CELL_COUNT) == 0) {
+		return;
+	}
+
+	int flagCount = 0;
+	for (long long ny = y - 1; ny <= y + 1; ++ny) {
+		for (long long nx = x - 1; nx <= x + 1; ++nx) {
+			if (cellAt(nx, ny) & CELL_FLAGGED) flagCount++;
+		}
+	}
+	if (flagCount == (current & CELL_COUNT)) {
+		for (long long ny = y - 1; ny <= y + 1; ++ny) {
+			for (long long nx = x - 1; nx <= x + 1; ++nx) {
+				floodReveal(nx, ny);
+			}
+		}
+	}
+}
+
+//End of InfiniteBoard.cpp
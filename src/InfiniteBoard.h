@@ -0,0 +1,94 @@
+#pragma once
+#ifndef INFINITEBOARD_H
+#define INFINITEBOARD_H
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "Board.h"
+
+//Unbounded board for endurance play. Whether a cell holds a mine is a pure function of
+//hash(seed, chunkX, chunkY) and the cell's place in its 64x64 chunk, so any chunk can be rebuilt on demand.
+//Chunks live in an LRU cache of bounded size; an evicted chunk keeps only a bitmap of its revealed and
+//flagged cells, which is replayed onto the regenerated mines when play comes back to it.
+//Reveal, flag and chord follow Board's rules. There is no win: the game runs until a mine is hit.
+class InfiniteBoard {
+	public:
+		static const int chunkShift = 6;
+		static const int chunkSize = 1 << chunkShift;
+
+		//density is the chance of each cell holding a mine. Below about 0.15 openings percolate and a
+		//single click could flood forever, so lower values are rejected.
+		InfiniteBoard(double density, uint64_t seed, size_t maxCachedChunks = 4096);
+
+		void revealCell(long long x, long long y);
+		void toggleFlag(long long x, long long y);
+		void chordCell(long long x, long long y);
+		//Does not load anything into the cache, so views can sweep large areas freely
+		Cell getCell(long long x, long long y) const;
+
+		double getDensity() const;
+		uint64_t getSeed() const;
+		bool getIsGameOver() const;
+		long long getCellsRevealed() const;
+		long long getFlagsPlaced() const;
+		size_t getCachedChunkCount() const;
+		size_t getSavedChunkCount() const; //Evicted chunks kept as reveal/flag bitmaps
+
+		void resetBoard(uint64_t seed);
+
+	private:
+		struct ChunkKey {
+			long long x;
+			long long y;
+			bool operator==(const ChunkKey& other) const { return x == other.x && y == other.y; }
+		};
+		struct ChunkKeyHash {
+			size_t operator()(const ChunkKey& key) const;
+		};
+		struct Chunk {
+			ChunkKey key;
+			uint8_t cells[chunkSize * chunkSize]; //CellBits, counts always filled in
+		};
+		//What survives eviction: one bit per cell, one 64-bit word per row
+		struct SavedChunk {
+			uint64_t revealed[chunkSize];
+			uint64_t flagged[chunkSize];
+		};
+
+		double density;
+		uint64_t mineThreshold; //A cell is a mine when its hash falls below this
+		uint64_t seed;
+		size_t maxCachedChunks;
+
+		std::list<Chunk> lru; //Most recently used first
+		std::unordered_map<ChunkKey, std::list<Chunk>::iterator, ChunkKeyHash> cache;
+		std::unordered_map<ChunkKey, SavedChunk, ChunkKeyHash> saved;
+		Chunk* lastChunk; //Shortcut for the chunk of the previous lookup; floods mostly stay inside one
+
+		bool firstClickHandled;
+		long long firstX;
+		long long firstY;
+		bool isGameOver;
+		long long cellsRevealed;
+		long long flagsPlaced;
+
+		struct Coord {
+			long long x;
+			long long y;
+		};
+		std::vector<Coord> revealStack; //Flood fill worklist, reused between calls
+
+		static long long chunkOf(long long v) { return v >> chunkShift; } //Floors for negative coordinates too
+		static int localOf(long long v) { return static_cast<int>(v & (chunkSize - 1)); }
+
+		bool mineAt(long long x, long long y) const;
+		int countAt(long long x, long long y) const;
+		Chunk& loadChunk(const ChunkKey& key);
+		void evictChunk();
+		uint8_t& cellAt(long long x, long long y);
+		void floodReveal(long long x, long long y);
+};
+
+#endif
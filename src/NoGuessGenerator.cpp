@@ -0,0 +1,44 @@
+#include "NoGuessGenerator.h"
+#include "Board.h"
+#include "Solver.h"
+#include "Random.h"
+#include <atomic>
+
+NoGuessGenerator::NoGuessGenerator(int threads) : pool(threads), attempts(0)
+{
+}
+
+int NoGuessGenerator::getAttempts() const { return attempts; }
+
+bool NoGuessGenerator::findSeed(int width, int height, int mineCount, int firstX, int firstY, uint64_t baseSeed,
+	uint64_t& seed, int maxAttempts)
+{
+	if (static_cast<long long>(width) * height > maxCells) {
+		attempts = 0;
+		return false;
+	}
+
+	//Every candidate below the best one found so far is still solved, which keeps the winner deterministic;
+	//candidates above it are skipped, so the pool drains quickly once something qualifies
+	std::atomic<int> best(maxAttempts);
+	std::atomic<int> solved(0);
+	pool.parallelFor(maxAttempts, [&](int candidate) {
+		if (candidate >= best.load(std::memory_order_relaxed)) return;
+		solved.fetch_add(1, std::memory_order_relaxed);
+
+		Board board(width, height, mineCount, hashSeed(baseSeed, static_cast<uint64_t>(candidate), 0));
+		Solver solver(board);
+		solver.reveal(firstX, firstY);
+		if (!solver.solve()) return;
+
+		int current = best.load();
+		while (candidate < current && !best.compare_exchange_weak(current, candidate)) {}
+	});
+
+	attempts = solved.load();
+	if (best.load() == maxAttempts) return false;
+	seed = hashSeed(baseSeed, static_cast<uint64_t>(best.load()), 0);
+	return true;
+}
+
+//End of NoGuessGenerator.cpp
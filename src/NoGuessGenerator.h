@@ -0,0 +1,30 @@
+#pragma once
+#ifndef NOGUESSGENERATOR_H
+#define NOGUESSGENERATOR_H
+#include <cstdint>
+#include "ThreadPool.h"
+
+//Finds layouts the Solver clears from the first click without a single guess. Candidate seeds are laid out
+//and solved speculatively on every thread of the pool. The lowest-numbered candidate that works wins, so the
+//result depends only on the arguments, not on thread timing.
+class NoGuessGenerator {
+	public:
+		//Every pool thread holds a full Board and Solver for its candidate, so bigger boards are refused
+		static const int maxCells = 1 << 20;
+
+		explicit NoGuessGenerator(int threads = 0); //0 = one thread per hardware core
+
+		//Writes a seed whose layout, generated by a click on (firstX, firstY) with the default safe radius,
+		//needs no guessing. Returns false if none of maxAttempts candidates qualifies, or if the board has more
+		//than maxCells cells.
+		bool findSeed(int width, int height, int mineCount, int firstX, int firstY, uint64_t baseSeed,
+			uint64_t& seed, int maxAttempts = 20000);
+
+		int getAttempts() const; //Candidates solved by the last findSeed
+
+	private:
+		ThreadPool pool;
+		int attempts;
+};
+
+#endif
@@ -0,0 +1,314 @@
+#include "ProbabilityEngine.h"
+#include "UnionFind.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <map>
+
+ProbabilityEngine::ProbabilityEngine(int threads) : pool(threads)
+{
+}
+
+//Splits the frontier (hidden, unflagged cells next to a revealed number) into independent components.
+//Fills the known entries of probabilities and collects the hidden cells no number touches.
+void ProbabilityEngine::buildComponents(const Board& board, std::vector<double>& probabilities)
+{
+	const int width = board.getWidth();
+	const int height = board.getHeight();
+	const int total = width * height;
+
+	std::vector<Cell> view(total);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) view[y * width + x] = board.getCell(x, y);
+	}
+
+	//Constraints from every revealed number that still touches a hidden, unflagged cell
+	std::vector<int> frontierId(total, -1);
+	std::vector<int> frontier;
+	std::vector<int> constraintNeed;
+	std::vector<std::vector<int>> constraintCells;
+	for (int index = 0; index < total; ++index) {
+		const Cell& c = view[index];
+		probabilities[index] = c.isFlagged ? 1.0 : 0.0;
+		if (!c.isRevealed || c.isMine || c.adjacentMines == 0) continue;
+
+		int cx = index % width;
+		int cy = index / width;
+		int need = c.adjacentMines;
+		std::vector<int> cellsOfConstraint;
+		for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, height - 1); ++ny) {
+			for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, width - 1); ++nx) {
+				const Cell& n = view[ny * width + nx];
+				if (n.isFlagged) --need;
+				else if (!n.isRevealed) cellsOfConstraint.push_back(ny * width + nx);
+			}
+		}
+		if (cellsOfConstraint.empty()) continue;
+		for (int cell : cellsOfConstraint) {
+			if (frontierId[cell] < 0) {
+				frontierId[cell] = static_cast<int>(frontier.size());
+				frontier.push_back(cell);
+			}
+		}
+		constraintNeed.push_back(need);
+		constraintCells.push_back(std::move(cellsOfConstraint));
+	}
+
+	interior.clear();
+	for (int index = 0; index < total; ++index) {
+		if (!view[index].isRevealed && !view[index].isFlagged && frontierId[index] < 0) interior.push_back(index);
+	}
+
+	//Cells sharing a constraint belong to the same component
+	std::vector<int> parent(frontier.size());
+	std::iota(parent.begin(), parent.end(), 0);
+	for (const std::vector<int>& cellsOfConstraint : constraintCells) {
+		for (size_t i = 1; i < cellsOfConstraint.size(); ++i) {
+			uniteRoots(parent, frontierId[cellsOfConstraint[0]], frontierId[cellsOfConstraint[i]]);
+		}
+	}
+
+	components.clear();
+	std::vector<int> componentOf(frontier.size(), -1);
+	std::vector<std::vector<int>> constraintsOf;
+	for (size_t f = 0; f < frontier.size(); ++f) {
+		int root = findRoot(parent, static_cast<int>(f));
+		if (componentOf[root] < 0) {
+			componentOf[root] = static_cast<int>(components.size());
+			components.emplace_back();
+			constraintsOf.emplace_back();
+		}
+	}
+	for (size_t c = 0; c < constraintCells.size(); ++c) {
+		constraintsOf[componentOf[findRoot(parent, frontierId[constraintCells[c][0]])]].push_back(static_cast<int>(c));
+	}
+
+	//Order each component's cells breadth-first through shared constraints so constraints close early
+	std::vector<std::vector<int>> constraintsOfCell(frontier.size());
+	for (size_t c = 0; c < constraintCells.size(); ++c) {
+		for (int cell : constraintCells[c]) constraintsOfCell[frontierId[cell]].push_back(static_cast<int>(c));
+	}
+	std::vector<int> localId(frontier.size(), -1);
+	std::vector<int> constraintLocal(constraintCells.size(), -1);
+	for (size_t k = 0; k < components.size(); ++k) {
+		Component& component = components[k];
+		const std::vector<int>& constraints = constraintsOf[k];
+		for (size_t i = 0; i < constraints.size(); ++i) {
+			constraintLocal[constraints[i]] = static_cast<int>(i);
+			component.needs.push_back(constraintNeed[constraints[i]]);
+		}
+
+		std::vector<int> order;
+		int first = frontierId[constraintCells[constraints[0]][0]];
+		localId[first] = 0;
+		order.push_back(first);
+		for (size_t head = 0; head < order.size(); ++head) {
+			for (int c : constraintsOfCell[order[head]]) {
+				for (int cell : constraintCells[c]) {
+					int f = frontierId[cell];
+					if (localId[f] < 0) {
+						localId[f] = static_cast<int>(order.size());
+						order.push_back(f);
+					}
+				}
+			}
+		}
+
+		//Group cells by their constraint set, keeping groups in first-seen (breadth-first) order
+		std::map<std::vector<int>, int> groupOf;
+		std::vector<std::vector<int>> groupCells;
+		for (int f : order) {
+			std::vector<int> key;
+			for (int c : constraintsOfCell[f]) key.push_back(constraintLocal[c]);
+			std::sort(key.begin(), key.end());
+			auto found = groupOf.find(key);
+			if (found == groupOf.end()) {
+				found = groupOf.emplace(key, static_cast<int>(groupCells.size())).first;
+				groupCells.emplace_back();
+				component.groupConstraints.push_back(key);
+			}
+			groupCells[found->second].push_back(frontier[f]);
+		}
+		for (const std::vector<int>& cellsOfGroup : groupCells) {
+			component.groupStart.push_back(static_cast<int>(component.cells.size()));
+			component.cells.insert(component.cells.end(), cellsOfGroup.begin(), cellsOfGroup.end());
+		}
+		component.groupStart.push_back(static_cast<int>(component.cells.size()));
+	}
+}
+
+//Depth-first enumeration of one component's layouts, one group at a time; a branch is cut as soon as
+//any constraint has too many mines or can no longer reach its count
+namespace {
+	struct Enumeration {
+		const std::vector<std::vector<int>>* groupConstraints;
+		std::vector<int> groupSize;
+		std::vector<int> need;
+		std::vector<int> placed;
+		std::vector<int> open; //Unassigned cells per constraint
+		std::vector<int> value; //Mines chosen in each group
+		std::vector<std::vector<double>> choose; //choose[n][k] = C(n, k) for n up to the largest group
+		std::vector<double>* solutions;
+		std::vector<std::vector<double>>* groupMines;
+		int groupCount;
+		int maxMines;
+
+		bool fits(int group, int mines) const {
+			const int size = groupSize[group];
+			for (int c : (*groupConstraints)[group]) {
+				int p = placed[c] + mines;
+				if (p > need[c] || p + open[c] - size < need[c]) return false;
+			}
+			return true;
+		}
+
+		void assign(int group, int mines, int delta) {
+			for (int c : (*groupConstraints)[group]) {
+				placed[c] += mines * delta;
+				open[c] -= groupSize[group] * delta;
+			}
+		}
+
+		void search(int group, int mines, double ways) {
+			if (group == groupCount) {
+				(*solutions)[mines] += ways;
+				std::vector<double>& counts = (*groupMines)[mines];
+				for (int g = 0; g < groupCount; ++g) counts[g] += ways * value[g];
+				return;
+			}
+			const int size = groupSize[group];
+			for (int k = 0; k <= size && mines + k <= maxMines; ++k) {
+				if (!fits(group, k)) continue;
+				value[group] = k;
+				assign(group, k, 1);
+				search(group + 1, mines + k, ways * choose[size][k]);
+				assign(group, k, -1);
+			}
+		}
+	};
+}
+
+void ProbabilityEngine::enumerate(Component& component, int maxMines)
+{
+	const int n = static_cast<int>(component.cells.size());
+	const int groups = static_cast<int>(component.groupConstraints.size());
+	component.solutions.assign(n + 1, 0.0);
+	component.groupMines.assign(n + 1, std::vector<double>(groups, 0.0));
+
+	Enumeration e;
+	e.groupConstraints = &component.groupConstraints;
+	e.need = component.needs;
+	e.placed.assign(e.need.size(), 0);
+	e.open.assign(e.need.size(), 0);
+	int largest = 0;
+	for (int g = 0; g < groups; ++g) {
+		int size = component.groupStart[g + 1] - component.groupStart[g];
+		e.groupSize.push_back(size);
+		largest = std::max(largest, size);
+		for (int c : component.groupConstraints[g]) e.open[c] += size;
+	}
+	for (size_t c = 0; c < e.need.size(); ++c) {
+		if (e.need[c] < 0 || e.need[c] > e.open[c]) return;
+	}
+	e.choose.assign(largest + 1, std::vector<double>(largest + 1, 0.0));
+	for (int i = 0; i <= largest; ++i) {
+		e.choose[i][0] = 1.0;
+		for (int k = 1; k <= i; ++k) e.choose[i][k] = e.choose[i - 1][k - 1] + (k < i ? e.choose[i - 1][k] : 0.0);
+	}
+	e.value.assign(groups, 0);
+	e.solutions = &component.solutions;
+	e.groupMines = &component.groupMines;
+	e.groupCount = groups;
+	e.maxMines = maxMines;
+	e.search(0, 0, 1.0);
+}
+
+//Convolution of two mine-count distributions, truncated to limit + 1 entries
+static std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b, int limit)
+{
+	std::vector<double> result(std::min<size_t>(a.size() + b.size() - 1, static_cast<size_t>(limit) + 1), 0.0);
+	for (size_t i = 0; i < a.size() && i < result.size(); ++i) {
+		if (a[i] == 0.0) continue;
+		for (size_t j = 0; j < b.size() && i + j < result.size(); ++j) {
+			result[i + j] += a[i] * b[j];
+		}
+	}
+	return result;
+}
+
+bool ProbabilityEngine::compute(const Board& board, std::vector<double>& probabilities)
+{
+	const int total = board.getWidth() * board.getHeight();
+	probabilities.assign(total, 0.0);
+	buildComponents(board, probabilities);
+	const int interiorCount = static_cast<int>(interior.size());
+
+	const int remaining = board.getMineCount() - board.getFlagsPlaced();
+	if (remaining < 0) return false;
+
+	//Largest components first so the slowest enumeration starts immediately
+	std::sort(components.begin(), components.end(), [](const Component& a, const Component& b) {
+		return a.cells.size() > b.cells.size();
+	});
+	pool.parallelFor(static_cast<int>(components.size()), [&](int k) { enumerate(components[k], remaining); });
+
+	//prefix[k] / suffix[k]: frontier mine distribution of components before k / from k on
+	const size_t count = components.size();
+	std::vector<std::vector<double>> prefix(count + 1), suffix(count + 1);
+	prefix[0] = { 1.0 };
+	suffix[count] = { 1.0 };
+	for (size_t k = 0; k < count; ++k) prefix[k + 1] = convolve(prefix[k], components[k].solutions, remaining);
+	for (size_t k = count; k-- > 0;) suffix[k] = convolve(components[k].solutions, suffix[k + 1], remaining);
+
+	//Weight of M frontier mines: the ways to place the other remaining - M mines in the interior,
+	//scaled by the largest weight so huge binomials stay in range
+	std::vector<double> interiorWeight(remaining + 1, 0.0);
+	double maxLog = -HUGE_VAL;
+	std::vector<double> logWeight(remaining + 1, -HUGE_VAL);
+	for (int m = 0; m <= remaining; ++m) {
+		int rest = remaining - m;
+		if (rest > interiorCount) continue;
+		logWeight[m] = std::lgamma(interiorCount + 1.0) - std::lgamma(rest + 1.0) - std::lgamma(interiorCount - rest + 1.0);
+		maxLog = std::max(maxLog, logWeight[m]);
+	}
+	for (int m = 0; m <= remaining; ++m) {
+		if (logWeight[m] > -HUGE_VAL) interiorWeight[m] = std::exp(logWeight[m] - maxLog);
+	}
+
+	const std::vector<double>& all = prefix[count];
+	double totalWeight = 0.0;
+	double interiorMines = 0.0;
+	for (size_t m = 0; m < all.size(); ++m) {
+		totalWeight += all[m] * interiorWeight[m];
+		interiorMines += all[m] * interiorWeight[m] * (remaining - static_cast<int>(m));
+	}
+	if (totalWeight <= 0.0) return false;
+
+	for (size_t k = 0; k < count; ++k) {
+		const Component& component = components[k];
+		std::vector<double> others = convolve(prefix[k], suffix[k + 1], remaining);
+		for (size_t m = 0; m < component.solutions.size(); ++m) {
+			if (component.solutions[m] == 0.0) continue;
+			double weight = 0.0;
+			for (size_t o = 0; o < others.size() && m + o <= static_cast<size_t>(remaining); ++o) {
+				weight += others[o] * interiorWeight[m + o];
+			}
+			weight /= totalWeight;
+			const std::vector<double>& counts = component.groupMines[m];
+			for (size_t g = 0; g < counts.size(); ++g) {
+				const int first = component.groupStart[g];
+				const int last = component.groupStart[g + 1];
+				const double share = counts[g] * weight / (last - first);
+				for (int i = first; i < last; ++i) probabilities[component.cells[i]] += share;
+			}
+		}
+	}
+
+	if (interiorCount > 0) {
+		const double interiorProbability = interiorMines / totalWeight / interiorCount;
+		for (int index : interior) probabilities[index] = interiorProbability;
+	}
+	return true;
+}
+
+//End of ProbabilityEngine.cpp
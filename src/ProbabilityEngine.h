@@ -0,0 +1,40 @@
+#pragma once
+#ifndef PROBABILITYENGINE_H
+#define PROBABILITYENGINE_H
+#include <vector>
+#include "Board.h"
+#include "ThreadPool.h"
+
+//Exact mine probabilities for every hidden cell of a Board, for when no deterministic move exists.
+//The frontier is split into independent constraint components, each component's solutions are
+//enumerated with pruning (in parallel across the pool), and the results are combined with binomial
+//weights for the unconstrained interior. Flags count as mines.
+class ProbabilityEngine {
+	public:
+		explicit ProbabilityEngine(int threads = 0); //0 = one thread per hardware core
+
+		//Fills probabilities (row-major, width*height) with P(mine): 0 for revealed cells, 1 for flagged ones.
+		//Returns false if the revealed numbers and flags admit no layout (e.g. a wrong flag).
+		bool compute(const Board& board, std::vector<double>& probabilities);
+
+	private:
+		//Cells with exactly the same constraints are interchangeable, so they are enumerated as one group
+		//by how many of them are mines, weighted by the binomial number of ways to choose them
+		struct Component {
+			std::vector<int> cells; //Board indices, grouped and in enumeration order
+			std::vector<int> groupStart; //Group g owns cells[groupStart[g] .. groupStart[g + 1])
+			std::vector<std::vector<int>> groupConstraints; //Constraints touching each group (local ids)
+			std::vector<int> needs; //Mines still required by each constraint
+			std::vector<double> solutions; //Layouts by number of mines in the component
+			std::vector<std::vector<double>> groupMines; //[mines][group]: layouts weighted by mines in the group
+		};
+
+		ThreadPool pool;
+		std::vector<Component> components;
+		std::vector<int> interior; //Hidden, unflagged cells that touch no revealed number
+
+		void buildComponents(const Board& board, std::vector<double>& probabilities);
+		static void enumerate(Component& component, int maxMines);
+};
+
+#endif
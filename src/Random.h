@@ -0,0 +1,72 @@
+#pragma once
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <cstdint>
+
+//Small, fast, explicitly seeded generator (xoshiro256**) so any board can be regenerated from its seed
+class Random {
+	public:
+		explicit Random(uint64_t seed) { reseed(seed); }
+
+		//Expands the 64-bit seed into the full state with splitmix64, as recommended by the xoshiro authors
+		void reseed(uint64_t seed) {
+			for (uint64_t& word : state) {
+				seed += 0x9E3779B97F4A7C15ull;
+				uint64_t z = seed;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				word = z ^ (z >> 31);
+			}
+		}
+
+		uint64_t next() {
+			const uint64_t result = rotl(state[1] * 5, 7) * 9;
+			const uint64_t t = state[1] << 17;
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = rotl(state[3], 45);
+			return result;
+		}
+
+		//Uniform value in [0, bound) without modulo bias (Lemire's multiply-and-reject)
+		uint32_t below(uint32_t bound) {
+			uint64_t m = static_cast<uint64_t>(static_cast<uint32_t>(next() >> 32)) * bound;
+			uint32_t low = static_cast<uint32_t>(m);
+			if (low < bound) {
+				const uint32_t threshold = (0u - bound) % bound;
+				while (low < threshold) {
+					m = static_cast<uint64_t>(static_cast<uint32_t>(next() >> 32)) * bound;
+					low = static_cast<uint32_t>(m);
+				}
+			}
+			return static_cast<uint32_t>(m >> 32);
+		}
+
+	private:
+		uint64_t state[4];
+		static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+//Splitmix-style hash of a seed and two keys, for deriving independent streams (per chunk, per tree node, ...)
+inline uint64_t hashSeed(uint64_t seed, uint64_t a, uint64_t b)
+{
+	uint64_t z = seed ^ (a * 0x9E3779B97F4A7C15ull) ^ (b * 0xD6E8FEB86659FD93ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+//Seed of game number game in a batch run from base; simulate and board_stats both number games this way,
+//so game i of one is board i of the other
+inline uint64_t gameSeed(uint64_t base, long long game)
+{
+	uint64_t z = base + static_cast<uint64_t>(game) * 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+#endif
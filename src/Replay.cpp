@@ -0,0 +1,109 @@
+#include "Replay.h"
+#include <algorithm>
+#include <climits>
+
+Replay::Replay(const ActionLog& log, Board& board, size_t keyframeInterval)
+	: log(log), board(board), keyframeInterval(std::max<size_t>(keyframeInterval, 1)), keyframesEnabled(true),
+	  savedUndoDepth(board.getUndoDepth()), savedUndoMaxCells(board.getUndoMaxCells())
+{
+	//Undo needs the journal of everything before it, which a keyframe does not hold. Logs with undo/redo
+	//therefore seek from the start, on a board whose journal never forgets (only successful undos are logged).
+	ActionLog::Cursor scan;
+	Action action;
+	while (log.next(scan, action)) {
+		if (action.type == ACTION_UNDO || action.type == ACTION_REDO) {
+			keyframesEnabled = false;
+			board.setUndoLimit(INT_MAX, SIZE_MAX);
+			break;
+		}
+	}
+	restart();
+}
+
+Replay::~Replay()
+{
+	board.setUndoLimit(savedUndoDepth, savedUndoMaxCells);
+}
+
+size_t Replay::getPosition() const { return cursor.index; }
+size_t Replay::size() const { return log.size(); }
+bool Replay::atEnd() const { return cursor.index >= log.size(); }
+uint32_t Replay::getTimeMs() const { return cursor.timeMs; }
+
+void Replay::restart()
+{
+	board.setSafeRadius(log.getSafeRadius());
+	board.resetBoard(log.getSeed());
+	cursor = ActionLog::Cursor();
+}
+
+void Replay::apply(const Action& action)
+{
+	switch (action.type) {
+		case ACTION_REVEAL: board.revealCell(action.x, action.y); break;
+		case ACTION_FLAG: board.toggleFlag(action.x, action.y); break;
+		case ACTION_CHORD: board.chordCell(action.x, action.y); break;
+		case ACTION_UNDO: board.undo(); break;
+		case ACTION_REDO: board.redo(); break;
+	}
+}
+
+bool Replay::step()
+{
+	Action action;
+	if (!log.next(cursor, action)) return false;
+	apply(action);
+
+	//Keyframes are taken the first time playback passes their position
+	if (keyframesEnabled && cursor.index % keyframeInterval == 0 && cursor.index / keyframeInterval == keyframes.size() + 1) {
+		Keyframe keyframe;
+		keyframe.cursor = cursor;
+		const size_t words = static_cast<size_t>(board.rowWords()) * board.getHeight();
+		keyframe.planes.resize(words * 3);
+		board.exportPlanes(keyframe.planes.data(), keyframe.planes.data() + words, keyframe.planes.data() + 2 * words);
+		keyframes.push_back(std::move(keyframe));
+	}
+	return true;
+}
+
+size_t Replay::fastForward(size_t count)
+{
+	size_t applied = 0;
+	while (applied < count && step()) ++applied;
+	return applied;
+}
+
+size_t Replay::advanceTo(uint32_t timeMs)
+{
+	size_t applied = 0;
+	ActionLog::Cursor peek = cursor;
+	Action action;
+	while (log.next(peek, action) && action.timeMs <= timeMs) {
+		step();
+		++applied;
+	}
+	return applied;
+}
+
+void Replay::restore(const Keyframe& keyframe)
+{
+	const size_t words = keyframe.planes.size() / 3;
+	board.importPlanes(keyframe.planes.data(), keyframe.planes.data() + words, keyframe.planes.data() + 2 * words, log.getSeed());
+	cursor = keyframe.cursor;
+}
+
+void Replay::seek(size_t position)
+{
+	position = std::min(position, log.size());
+	const size_t k = position / keyframeInterval; //Latest keyframe at or before position (0 = the start)
+	if (position < cursor.index) {
+		if (k > 0 && k <= keyframes.size()) restore(keyframes[k - 1]);
+		else restart();
+	} else if (k > cursor.index / keyframeInterval && k <= keyframes.size()) {
+		//Jumping forward past a keyframe we already have is cheaper than replaying up to it
+		restore(keyframes[k - 1]);
+	}
+	fastForward(position - cursor.index);
+}
+
+//End of Replay.cpp
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef REPLAY_H
+#define REPLAY_H
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "ActionLog.h"
+#include "Board.h"
+
+//Plays an ActionLog back onto a board. Moving forward applies actions directly through Board's API, with no
+//drawing, so a headless fast-forward runs at the speed of the board itself. Every keyframeInterval actions
+//the board is captured as bit planes (3 bits per cell); seeking backwards restores the nearest earlier
+//keyframe and replays from there instead of starting the game over.
+class Replay {
+	public:
+		//board must have the log's size and must not be recording into log; it is reset to the log's seed
+		Replay(const ActionLog& log, Board& board, size_t keyframeInterval = 65536);
+		~Replay(); //Gives the board back its own undo limit
+
+		size_t getPosition() const; //Actions applied so far
+		size_t size() const;
+		bool atEnd() const;
+		uint32_t getTimeMs() const; //Timestamp of the last applied action
+
+		bool step();
+		size_t fastForward(size_t count = SIZE_MAX); //Returns the number of actions applied
+		size_t advanceTo(uint32_t timeMs); //Applies every action stamped at or before timeMs, for real-time playback
+		void seek(size_t position);
+
+	private:
+		struct Keyframe {
+			ActionLog::Cursor cursor;
+			std::vector<uint64_t> planes; //Mines, revealed, flagged
+		};
+
+		const ActionLog& log;
+		Board& board;
+		size_t keyframeInterval;
+		ActionLog::Cursor cursor;
+		std::vector<Keyframe> keyframes; //keyframes[k] is the state after (k + 1) * keyframeInterval actions
+		bool keyframesEnabled;
+		int savedUndoDepth;
+		size_t savedUndoMaxCells;
+
+		void restart();
+		void restore(const Keyframe& keyframe);
+		void apply(const Action& action);
+};
+
+#endif
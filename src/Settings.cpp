@@ -1,5 +1,7 @@
 #include "Settings.h"
 #include "GameWindow.h"
+#include "BoardSnapshot.h"
+#include <FL/fl_ask.H>
 #include <string>
 #include <cstdlib>
 
@@ -11,6 +13,9 @@ SettingsWindow::SettingsWindow(int width, int height, const char* title) : Fl_Wi
 	heightInput = new Fl_Int_Input(150, 50, 150, 25, "Height:");
 	mineInput = new Fl_Int_Input(150, 80, 150, 25, "Mines:");
 
+	//Every game can be won without guessing
+	noGuessCheck = new Fl_Check_Button(150, 115, 150, 25, "No guessing");
+
 	//Default values
 	widthInput->value("9");
 	heightInput->value("9");
@@ -31,6 +36,10 @@ SettingsWindow::SettingsWindow(int width, int height, const char* title) : Fl_Wi
 	//Start Game button
 	startButton = new Fl_Button(150, 160, 150, 30, "Start Game");
 	startButton-> callback(start_cb, this);
+
+	//Continue the game saved when a game window was last closed
+	resumeButton = new Fl_Button(150, 200, 150, 30, "Resume Game");
+	resumeButton->callback(resume_cb, this);
 	end();
 }
 
@@ -46,8 +55,11 @@ void SettingsWindow::preset_cb(Fl_Widget* w, void* data)
 	const char* preset_cstr = static_cast<const char*>(data);
 	if (!preset_cstr) return;
 
-	int width = 0, height = 0, mines = 0;
-	sscanf_s(preset_cstr, "%d %d %d", &width, &height, &mines);
+	//Parse "width height mines" (strtol keeps this portable; sscanf_s is MSVC-only)
+	char* end = nullptr;
+	int width = static_cast<int>(std::strtol(preset_cstr, &end, 10));
+	int height = static_cast<int>(std::strtol(end, &end, 10));
+	int mines = static_cast<int>(std::strtol(end, &end, 10));
 
 	std::string wstr = std::to_string(width);
 	std::string hstr = std::to_string(height);
@@ -72,9 +84,9 @@ void SettingsWindow::start_cb(Fl_Widget* w, void* data)
 	int height = std::atoi(sw->heightInput->value());
 	int mines = std::atoi(sw->mineInput->value());
 
-	// If dimensions exceed 100x100, or mines invalid relative to board size,
+	// The game view scrolls and zooms, so only the storage limit applies: beyond 10000x10000,
 	// reset to default 9x9 with 5 mines.
-	if (width > 100 || height > 100) {
+	if (width > 10000 || height > 10000) {
 		width = 9;
 		height = 9;
 		mines = 5;
@@ -94,7 +106,23 @@ void SettingsWindow::start_cb(Fl_Widget* w, void* data)
 	}
 
 	//Create GameWindow with user defined settings
-	GameWindow* gw = new GameWindow(width, height, mines);
+	GameWindow* gw = new GameWindow(width, height, mines, sw->noGuessCheck->value() != 0);
 	//Close settings window
 	sw->hide();
-}
\ No newline at end of file
+}
+
+//Callback for Resume Game: reopens the saved game at its saved size
+void SettingsWindow::resume_cb(Fl_Widget* w, void* data)
+{
+	SettingsWindow* sw = static_cast<SettingsWindow*>(data);
+	if (!sw) return;
+
+	BoardSnapshot snapshot(GameWindow::saveFileName);
+	if (!snapshot.isValid()) {
+		fl_alert("No saved game to resume.");
+		return;
+	}
+	GameWindow* gw = new GameWindow(snapshot.getWidth(), snapshot.getHeight(), snapshot.getMineCount());
+	gw->resumeGame(snapshot);
+	sw->hide();
+}
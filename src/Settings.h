@@ -5,6 +5,7 @@
 #include <FL/Fl_Window.H>
 #include <FL/Fl_Button.H>
 #include <FL/Fl_Int_Input.H>
+#include <FL/Fl_Check_Button.H>
 
 
 class SettingsWindow : public Fl_Window {
@@ -18,7 +19,9 @@ class SettingsWindow : public Fl_Window {
 		Fl_Int_Input* widthInput;
 		Fl_Int_Input* heightInput;
 		Fl_Int_Input* mineInput;
+		Fl_Check_Button* noGuessCheck;
 		Fl_Button* startButton;
+		Fl_Button* resumeButton;
 
 		Fl_Button* Beginner_btn;
 		Fl_Button* Intermediate_btn;
@@ -26,6 +29,7 @@ class SettingsWindow : public Fl_Window {
 		//Callback for when Start Game button is clicked and preset games
 		static void start_cb(Fl_Widget* w, void* data);
 		static void preset_cb(Fl_Widget* w, void* data);
+		static void resume_cb(Fl_Widget* w, void* data);
 
 };
 
@@ -0,0 +1,166 @@
+#include "SharedBoard.h"
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+//Cells only ever gain or lose CELL_REVEALED / CELL_FLAGGED, one compare-and-swap at a time; mines and counts
+//are fixed at construction. No other memory is published through a cell, so relaxed ordering is enough.
+static const std::memory_order relaxed = std::memory_order_relaxed;
+
+SharedBoard::SharedBoard(const Board& board)
+	: width(board.getWidth()), height(board.getHeight()), mineCount(board.getMineCount()), stride(board.getWidth() + 2),
+	  cellsRevealed(board.getCellsRevealed()), flagsPlaced(board.getFlagsPlaced()),
+	  isGameOver(board.getIsGameOver()), isGameWon(board.getIsGameWon())
+{
+	const size_t total = static_cast<size_t>(stride) * (height + 2);
+	cells.reset(new std::atomic<uint8_t>[total]);
+	for (size_t i = 0; i < total; ++i) cells[i].store(CELL_BORDER | CELL_REVEALED, relaxed);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const Cell c = board.getCell(x, y);
+			uint8_t bits = static_cast<uint8_t>(c.adjacentMines);
+			if (c.isMine) bits |= CELL_MINE;
+			if (c.isRevealed) bits |= CELL_REVEALED;
+			if (c.isFlagged) bits |= CELL_FLAGGED;
+			cells[cellIndex(x, y)].store(bits, relaxed);
+		}
+	}
+	const int offsets[8] = {
+		-stride - 1, -stride, -stride + 1,
+		-1,                    1,
+		stride - 1,  stride,  stride + 1
+	};
+	std::copy(offsets, offsets + 8, neighbourOffsets);
+}
+
+int SharedBoard::getWidth() const { return width; }
+int SharedBoard::getHeight() const { return height; }
+int SharedBoard::getMineCount() const { return mineCount; }
+int SharedBoard::getFlagsPlaced() const { return flagsPlaced.load(); }
+int SharedBoard::getCellsRevealed() const { return cellsRevealed.load(); }
+bool SharedBoard::getIsGameOver() const { return isGameOver.load(); }
+bool SharedBoard::getIsGameWon() const { return isGameWon.load(); }
+
+Cell SharedBoard::getCell(int x, int y) const
+{
+	return Cell(cells[cellIndex(x, y)].load(relaxed));
+}
+
+bool SharedBoard::claim(int index, uint8_t& bits)
+{
+	bits = cells[index].load(relaxed);
+	do {
+		//Revealed covers the border too
+		if (bits & (CELL_REVEALED | CELL_FLAGGED)) return false;
+	} while (!cells[index].compare_exchange_weak(bits, static_cast<uint8_t>(bits | CELL_REVEALED), relaxed));
+	return true;
+}
+
+//Same flood as Board::floodReveal, except that a cell is only expanded by the call whose claim revealed it.
+//Two floods that meet simply stop at each other's cells, and between them every cell is visited once.
+//Returns the safe cells it revealed; a mine it reveals is added to minesHit instead.
+int SharedBoard::floodReveal(int index, int& minesHit)
+{
+	uint8_t bits;
+	if (!claim(index, bits)) return 0;
+	if (bits & CELL_MINE) {
+		++minesHit;
+		return 0;
+	}
+
+	//Each thread keeps its own worklist, reused between calls
+	thread_local std::vector<int> revealStack;
+	revealStack.clear();
+	revealStack.push_back(index);
+	int revealed = 1;
+	while (!revealStack.empty()) {
+		const int current = revealStack.back();
+		revealStack.pop_back();
+		if (cells[current].load(relaxed) & CELL_COUNT) continue;
+
+		for (int off : neighbourOffsets) {
+			//A zero cell has no mine neighbours, so a successful claim never hits one
+			if (!claim(current + off, bits)) continue;
+			++revealed;
+			revealStack.push_back(current + off);
+		}
+	}
+	return revealed;
+}
+
+//Counters move once per call; exactly one call sees the total reach the number of safe cells, and like
+//Board it only wins if no mine has gone off
+void SharedBoard::finishReveal(int revealed, int minesHit)
+{
+	if (minesHit > 0) isGameOver.store(true);
+	if (revealed == 0) return;
+	if (cellsRevealed.fetch_add(revealed) + revealed == width * height - mineCount && !isGameOver.load()) {
+		isGameWon.store(true);
+		isGameOver.store(true);
+	}
+}
+
+int SharedBoard::revealCell(int x, int y)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height) return 0;
+	int minesHit = 0;
+	const int revealed = floodReveal(cellIndex(x, y), minesHit);
+	finishReveal(revealed, minesHit);
+	return revealed + minesHit;
+}
+
+int SharedBoard::toggleFlag(int x, int y)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height) {
+		throw std::out_of_range("Cell coordinates is out of range!");
+	}
+	std::atomic<uint8_t>& c = cells[cellIndex(x, y)];
+	uint8_t bits = c.load(relaxed);
+	do {
+		if (bits & CELL_REVEALED) return 0;
+	} while (!c.compare_exchange_weak(bits, static_cast<uint8_t>(bits ^ CELL_FLAGGED), relaxed));
+	flagsPlaced.fetch_add((bits & CELL_FLAGGED) ? -1 : 1);
+	return 1;
+}
+
+//The flag count is a snapshot: a neighbour flagged or unflagged by another thread meanwhile is seen either way
+int SharedBoard::chordCell(int x, int y)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height) return 0;
+	const int index = cellIndex(x, y);
+	const uint8_t bits = cells[index].load(relaxed);
+	if (!(bits & CELL_REVEALED) || (bits & CELL_COUNT) == 0) return 0;
+
+	int flagCount = 0;
+	for (int off : neighbourOffsets) {
+		if (cells[index + off].load(relaxed) & CELL_FLAGGED) ++flagCount;
+	}
+	if (flagCount != (bits & CELL_COUNT)) return 0;
+
+	int minesHit = 0;
+	int revealed = 0;
+	for (int off : neighbourOffsets) revealed += floodReveal(index + off, minesHit);
+	finishReveal(revealed, minesHit);
+	return revealed + minesHit;
+}
+
+void SharedBoard::exportPlanes(uint64_t* mines, uint64_t* revealed, uint64_t* flagged) const
+{
+	const int words = rowWords();
+	const size_t total = static_cast<size_t>(words) * height;
+	std::fill(mines, mines + total, 0ull);
+	std::fill(revealed, revealed + total, 0ull);
+	std::fill(flagged, flagged + total, 0ull);
+	for (int y = 0; y < height; ++y) {
+		const size_t row = static_cast<size_t>(y) * words;
+		for (int x = 0; x < width; ++x) {
+			const uint8_t bits = cells[cellIndex(x, y)].load(relaxed);
+			const uint64_t bit = 1ull << (x & 63);
+			if (bits & CELL_MINE) mines[row + (x >> 6)] |= bit;
+			if (bits & CELL_REVEALED) revealed[row + (x >> 6)] |= bit;
+			if (bits & CELL_FLAGGED) flagged[row + (x >> 6)] |= bit;
+		}
+	}
+}
+
+//End of SharedBoard.cpp
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef SHAREDBOARD_H
+#define SHAREDBOARD_H
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include "Board.h"
+
+//Board variant for co-op and race modes: any number of threads may reveal, flag and chord on it at once.
+//Cells keep Board's one-byte layout, but each is atomic and changes only through a compare-and-swap from
+//hidden to revealed or flagged to unflagged. Every cell is therefore revealed or toggled by exactly one
+//call, flood fills from different threads may cross and merge anywhere, and no locks are taken.
+//Counters are atomic and updated once per call. There is no undo, recording or event publishing.
+class SharedBoard {
+	public:
+		//Takes over board's layout, revealed cells and flags. The mines must be final (after generate or
+		//the first click); a board before that has none to give.
+		explicit SharedBoard(const Board& board);
+
+		//Same rules as Board's actions. Each returns how many cells that call changed itself, so the returns of
+		//concurrent calls add up to the change in the counters plus any mines they set off (which, as in Board,
+		//getCellsRevealed() leaves out).
+		int revealCell(int x, int y);
+		int toggleFlag(int x, int y); //Throws std::out_of_range, like Board
+		int chordCell(int x, int y);
+
+		Cell getCell(int x, int y) const;
+		int getWidth() const;
+		int getHeight() const;
+		int getMineCount() const;
+		int getFlagsPlaced() const;
+		int getCellsRevealed() const;
+		bool getIsGameOver() const;
+		bool getIsGameWon() const;
+
+		//Same bit planes as Board, so a shared game can be snapshotted or handed back to a Board
+		int rowWords() const { return (width + 63) / 64; }
+		void exportPlanes(uint64_t* mines, uint64_t* revealed, uint64_t* flagged) const;
+
+	private:
+		int width;
+		int height;
+		int mineCount;
+		int stride; //width + 2, with the same border ring as Board
+		std::unique_ptr<std::atomic<uint8_t>[]> cells;
+		int neighbourOffsets[8];
+
+		std::atomic<int> cellsRevealed;
+		std::atomic<int> flagsPlaced;
+		std::atomic<bool> isGameOver;
+		std::atomic<bool> isGameWon;
+
+		int cellIndex(int x, int y) const { return (y + 1) * stride + (x + 1); }
+		bool claim(int index, uint8_t& bits); //Hidden -> revealed; true for the one caller that made the change
+		int floodReveal(int index, int& minesHit);
+		void finishReveal(int revealed, int minesHit);
+};
+
+#endif
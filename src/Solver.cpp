@@ -0,0 +1,255 @@
+#include "Solver.h"
+#include <algorithm>
+
+Solver::Solver(Board& board) : board(board), width(board.getWidth()), height(board.getHeight()), revealedCount(0)
+{
+	reset();
+}
+
+void Solver::reset()
+{
+	const size_t total = static_cast<size_t>(width) * height;
+	knowledge.assign(total, UNKNOWN);
+	counts.assign(total, 0);
+	queued.assign(total, 0);
+	dirty.clear();
+	pendingSafe.clear();
+	pendingMines.clear();
+	revealedCount = 0;
+
+	//Pick up whatever is already open; each sync floods over its connected revealed area
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			if (knowledge[y * width + x] == UNKNOWN && board.getCell(x, y).isRevealed) sync(y * width + x);
+		}
+	}
+}
+
+//Learns every cell newly revealed on the board that is connected to index through revealed cells.
+//A flood fill is always connected to the cell that started it, so this costs O(cells that changed).
+void Solver::sync(int index)
+{
+	syncStack.clear();
+	syncStack.push_back(index);
+	while (!syncStack.empty()) {
+		int current = syncStack.back();
+		syncStack.pop_back();
+		if (knowledge[current] == REVEALED) continue;
+
+		int cx = current % width;
+		int cy = current / width;
+		Cell c = board.getCell(cx, cy);
+		if (!c.isRevealed) continue;
+
+		knowledge[current] = REVEALED;
+		counts[current] = static_cast<uint8_t>(c.adjacentMines);
+		++revealedCount;
+		if (c.isMine) continue;
+
+		markDirtyAround(current);
+		if (c.adjacentMines > 0 && !queued[current]) {
+			queued[current] = 1;
+			dirty.push_back(current);
+		}
+		for (int dy = -1; dy <= 1; ++dy) {
+			for (int dx = -1; dx <= 1; ++dx) {
+				int nx = cx + dx;
+				int ny = cy + dy;
+				if ((dx || dy) && nx >= 0 && nx < width && ny >= 0 && ny < height && knowledge[ny * width + nx] != REVEALED) {
+					syncStack.push_back(ny * width + nx);
+				}
+			}
+		}
+	}
+}
+
+//Queues the revealed numbers around index, whose constraints just changed
+void Solver::markDirtyAround(int index)
+{
+	int cx = index % width;
+	int cy = index / width;
+	for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, height - 1); ++ny) {
+		for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, width - 1); ++nx) {
+			int n = ny * width + nx;
+			if (n != index && knowledge[n] == REVEALED && counts[n] > 0 && !queued[n]) {
+				queued[n] = 1;
+				dirty.push_back(n);
+			}
+		}
+	}
+}
+
+bool Solver::markSafe(int index)
+{
+	if (knowledge[index] != UNKNOWN) return false;
+	knowledge[index] = SAFE;
+	pendingSafe.push_back(index);
+	markDirtyAround(index);
+	return true;
+}
+
+bool Solver::markMine(int index)
+{
+	if (knowledge[index] != UNKNOWN) return false;
+	knowledge[index] = MINE;
+	pendingMines.push_back(index);
+	markDirtyAround(index);
+	return true;
+}
+
+//Fills unknown with the undecided neighbours of index and returns how many there are
+int Solver::collectUnknown(int index, int* unknown, int& knownMines) const
+{
+	int cx = index % width;
+	int cy = index / width;
+	int n = 0;
+	knownMines = 0;
+	for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, height - 1); ++ny) {
+		for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, width - 1); ++nx) {
+			int neighbour = ny * width + nx;
+			if (knowledge[neighbour] == UNKNOWN) unknown[n++] = neighbour;
+			else if (knowledge[neighbour] == MINE) ++knownMines;
+		}
+	}
+	return n;
+}
+
+//Applies the single-cell rule to index, then the subset rule against every number within two cells
+void Solver::examine(int index)
+{
+	int unknownA[8];
+	int minesA = 0;
+	int countA = collectUnknown(index, unknownA, minesA);
+	if (countA == 0) return;
+	int remainingA = counts[index] - minesA;
+
+	if (remainingA == 0 || remainingA == countA) {
+		for (int i = 0; i < countA; ++i) {
+			if (remainingA == 0) markSafe(unknownA[i]);
+			else markMine(unknownA[i]);
+		}
+		return;
+	}
+
+	int cx = index % width;
+	int cy = index / width;
+	for (int ny = std::max(cy - 2, 0); ny <= std::min(cy + 2, height - 1); ++ny) {
+		for (int nx = std::max(cx - 2, 0); nx <= std::min(cx + 2, width - 1); ++nx) {
+			int other = ny * width + nx;
+			if (other == index || knowledge[other] != REVEALED || counts[other] == 0) continue;
+
+			int unknownB[8];
+			int minesB = 0;
+			int countB = collectUnknown(other, unknownB, minesB);
+			if (countB == 0) continue;
+			int remainingB = counts[other] - minesB;
+
+			//Orient the pair so small is the candidate subset of large
+			const bool aIsSmall = countA <= countB;
+			const int* small = aIsSmall ? unknownA : unknownB;
+			const int* large = aIsSmall ? unknownB : unknownA;
+			const int smallCount = aIsSmall ? countA : countB;
+			const int largeCount = aIsSmall ? countB : countA;
+			if (smallCount == largeCount) continue;
+
+			//Both lists are in row-major order, so a merge walk tests the subset and builds the difference
+			int difference[8];
+			int differenceCount = 0;
+			int i = 0;
+			for (int j = 0; j < largeCount; ++j) {
+				if (i < smallCount && small[i] == large[j]) ++i;
+				else difference[differenceCount++] = large[j];
+			}
+			if (i != smallCount) continue;
+
+			int remainingDifference = aIsSmall ? remainingB - remainingA : remainingA - remainingB;
+			if (remainingDifference != 0 && remainingDifference != differenceCount) continue;
+
+			bool changed = false;
+			for (int k = 0; k < differenceCount; ++k) {
+				changed |= remainingDifference == 0 ? markSafe(difference[k]) : markMine(difference[k]);
+			}
+			if (changed) {
+				//Our own unknown set changed; look again once the queue reaches us
+				if (!queued[index]) {
+					queued[index] = 1;
+					dirty.push_back(index);
+				}
+				return;
+			}
+		}
+	}
+}
+
+bool Solver::analyze()
+{
+	const size_t before = pendingSafe.size() + pendingMines.size();
+	while (!dirty.empty()) {
+		int index = dirty.back();
+		dirty.pop_back();
+		queued[index] = 0;
+		examine(index);
+	}
+	return pendingSafe.size() + pendingMines.size() > before;
+}
+
+std::vector<CellCoord> Solver::getSafeCells() const
+{
+	std::vector<CellCoord> result;
+	for (int index : pendingSafe) result.push_back({ index % width, index / width });
+	return result;
+}
+
+std::vector<CellCoord> Solver::getMineCells() const
+{
+	std::vector<CellCoord> result;
+	for (int index : pendingMines) result.push_back({ index % width, index / width });
+	return result;
+}
+
+bool Solver::isKnownMine(int x, int y) const { return knowledge[y * width + x] == MINE; }
+bool Solver::isKnownSafe(int x, int y) const { return knowledge[y * width + x] == SAFE || knowledge[y * width + x] == REVEALED; }
+
+int Solver::step()
+{
+	analyze();
+	int played = 0;
+
+	for (int index : pendingMines) {
+		int x = index % width;
+		int y = index / width;
+		if (!board.getCell(x, y).isFlagged) board.toggleFlag(x, y);
+		++played;
+	}
+	pendingMines.clear();
+
+	//Take the list first: revealing can queue more deductions behind it
+	std::vector<int> safe;
+	safe.swap(pendingSafe);
+	for (int index : safe) {
+		if (board.getIsGameOver()) break;
+		if (knowledge[index] != SAFE) continue;
+		reveal(index % width, index / width);
+		++played;
+	}
+	return played;
+}
+
+void Solver::reveal(int x, int y)
+{
+	//A wrong flag (placed by a player) would block the reveal
+	if (board.getCell(x, y).isFlagged) board.toggleFlag(x, y);
+	board.revealCell(x, y);
+	sync(y * width + x);
+}
+
+bool Solver::solve()
+{
+	if (revealedCount == 0 && !board.getIsGameOver()) reveal(width / 2, height / 2);
+	while (!board.getIsGameOver()) {
+		if (step() == 0) break;
+	}
+	return board.getIsGameWon();
+}
+
+//End of Solver.cpp
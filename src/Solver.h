@@ -0,0 +1,63 @@
+#pragma once
+#ifndef SOLVER_H
+#define SOLVER_H
+#include <vector>
+#include <cstdint>
+#include "Board.h"
+
+struct CellCoord {
+	int x;
+	int y;
+};
+
+//Deterministic constraint-propagation player that only uses Board's public interface.
+//Applies the single-cell rule (remaining mines == 0 or == hidden neighbours) and the pairwise subset rule
+//between nearby numbers. Only numbers whose neighbourhood changed since the last step are re-examined.
+class Solver {
+	public:
+		explicit Solver(Board& board);
+
+		//Rescans the whole board; call after the board was reset or changed behind the solver's back
+		void reset();
+
+		//Runs the rules over the changed frontier; returns true if anything new was deduced
+		bool analyze();
+		//Cells proved safe / proved mines by analyze() that have not been played yet
+		std::vector<CellCoord> getSafeCells() const;
+		std::vector<CellCoord> getMineCells() const;
+		bool isKnownMine(int x, int y) const;
+		bool isKnownSafe(int x, int y) const;
+
+		//Flags every proved mine and reveals every proved safe cell; returns the number of cells played
+		int step();
+		//Opens the centre if nothing is revealed, then steps until won, lost or out of deductions.
+		//Returns true if the game was won; false means a guess is needed (or the game was lost).
+		bool solve();
+
+		//Moves made on the solver's behalf (e.g. a guess) so its view stays in sync
+		void reveal(int x, int y);
+
+	private:
+		enum Knowledge : uint8_t { UNKNOWN, REVEALED, SAFE, MINE };
+
+		Board& board;
+		int width;
+		int height;
+		std::vector<uint8_t> knowledge;
+		std::vector<uint8_t> counts; //Adjacent mine count of revealed cells
+		std::vector<uint8_t> queued;
+		std::vector<int> dirty; //Revealed numbers whose neighbourhood changed
+		std::vector<int> pendingSafe;
+		std::vector<int> pendingMines;
+		std::vector<int> syncStack;
+		int revealedCount;
+
+		void sync(int index);
+		void markDirtyAround(int index);
+		void examine(int index);
+		bool markSafe(int index);
+		bool markMine(int index);
+		int collectUnknown(int index, int* unknown, int& knownMines) const;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) : job(nullptr), jobCount(0), next(0), busy(0), generation(0), stopping(false)
+{
+	if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+	if (threads <= 0) threads = 1;
+	for (int i = 1; i < threads; ++i) {
+		workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers) worker.join();
+}
+
+int ThreadPool::size() const
+{
+	return static_cast<int>(workers.size()) + 1;
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& task)
+{
+	if (count <= 0) return;
+	if (workers.empty() || count == 1) {
+		for (int i = 0; i < count; ++i) task(i);
+		return;
+	}
+
+	std::lock_guard<std::mutex> caller(callerMutex);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &task;
+		jobCount = count;
+		next = 0;
+		busy = static_cast<int>(workers.size());
+		++generation;
+	}
+	wake.notify_all();
+	runTasks();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return busy == 0; });
+	job = nullptr;
+}
+
+void ThreadPool::runTasks()
+{
+	for (;;) {
+		int i = next.fetch_add(1);
+		if (i >= jobCount) break;
+		(*job)(i);
+	}
+}
+
+void ThreadPool::workerLoop()
+{
+	uint64_t seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		wake.wait(lock, [&] { return stopping || generation != seen; });
+		if (stopping) return;
+		seen = generation;
+		lock.unlock();
+		runTasks();
+		lock.lock();
+		if (--busy == 0) done.notify_one();
+	}
+}
+
+//End of ThreadPool.cpp
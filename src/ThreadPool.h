@@ -0,0 +1,42 @@
+#pragma once
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+//Fixed set of worker threads for fork/join loops. Tasks are claimed one index at a time from a shared
+//counter, so idle threads keep pulling work until the loop is drained.
+class ThreadPool {
+	public:
+		explicit ThreadPool(int threads = 0); //0 = one thread per hardware core (the caller counts as one)
+		~ThreadPool();
+
+		int size() const; //Threads that run tasks, including the calling thread
+
+		//Calls task(i) for every i in [0, count) and returns once all calls have finished.
+		//The calling thread takes part; concurrent callers are serialized.
+		void parallelFor(int count, const std::function<void(int)>& task);
+
+	private:
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::mutex callerMutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+		const std::function<void(int)>* job;
+		int jobCount;
+		std::atomic<int> next;
+		int busy;
+		uint64_t generation;
+		bool stopping;
+
+		void workerLoop();
+		void runTasks();
+};
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef UNIONFIND_H
+#define UNIONFIND_H
+#include <vector>
+#include <algorithm>
+
+//Union-find over a plain index vector, so callers keep (and reuse) the buffer themselves.
+//parent[i] == i marks a root.
+
+//Root lookup with path halving
+inline int findRoot(std::vector<int>& parent, int i)
+{
+	while (parent[i] != i) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+//Joins the sets of a and b under the smaller root; false if they were already one set
+inline bool uniteRoots(std::vector<int>& parent, int a, int b)
+{
+	a = findRoot(parent, a);
+	b = findRoot(parent, b);
+	if (a == b) return false;
+	parent[std::max(a, b)] = std::min(a, b);
+	return true;
+}
+
+//One step of a row-major labeling pass over a padded grid (stride = width + 2): starts index as its own set
+//and joins it to each neighbour visited before it (above and to the left) that joins(neighbour) accepts.
+//Roots always stay on the earlier cell, so every parent precedes its child. Returns how many joins merged two sets.
+template <class Joins>
+inline int uniteVisited(std::vector<int>& parent, int index, int stride, Joins joins)
+{
+	const int visited[4] = { -stride - 1, -stride, -stride + 1, -1 };
+	parent[index] = index;
+	int merges = 0;
+	for (int off : visited) {
+		if (joins(index + off) && uniteRoots(parent, index, index + off)) ++merges;
+	}
+	return merges;
+}
+
+#endif
@@ -1,6 +1,31 @@
 #include <iostream>
 #include <string>
 #include "Board.h"
+#include "ChunkedBoard.h"
+#include "InfiniteBoard.h"
+#include "BoardSnapshot.h"
+#include "ActionLog.h"
+#include "Replay.h"
+#include "NoGuessGenerator.h"
+#include "BoardAnalyzer.h"
+#include "GameProtocol.h"
+#include "SharedBoard.h"
+#include <thread>
+#include <atomic>
+#ifdef __linux__
+#include "GameServer.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+#include <cstdio>
+#include "Solver.h"
+#include "ProbabilityEngine.h"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "Random.h"
 
 static int g_tests = 0;
 static int g_fails = 0;
@@ -56,6 +81,1042 @@ void TestChordNoCrash() {
     EXPECT_TRUE(true); // if we reach here, assume no crash
 }
 
+void TestLargeOpeningReveal() {
+    // A mine-free board opens completely from one click; recursion used to overflow here
+    Board b(1000,1000,0);
+    b.revealCell(500,500);
+    EXPECT_TRUE(b.getCell(0,0).isRevealed);
+    EXPECT_TRUE(b.getCell(999,999).isRevealed);
+    EXPECT_TRUE(b.getIsGameWon());
+}
+
+void TestAdjacentCountsMatchMines() {
+    // Wide enough to exercise both the vector kernel and its scalar tail
+    Board b(77,20,300);
+    b.revealCell(0,0);
+    int mismatches = 0;
+    for (int y = 0; y < b.getHeight(); ++y) {
+        for (int x = 0; x < b.getWidth(); ++x) {
+            int expected = 0;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = x + dx, ny = y + dy;
+                    if ((dx || dy) && nx >= 0 && nx < b.getWidth() && ny >= 0 && ny < b.getHeight() && b.getCell(nx,ny).isMine) ++expected;
+                }
+            }
+            if (b.getCell(x,y).adjacentMines != expected) ++mismatches;
+        }
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+static int CountMines(const Board& b) {
+    int mines = 0;
+    for (int y = 0; y < b.getHeight(); ++y)
+        for (int x = 0; x < b.getWidth(); ++x)
+            if (b.getCell(x,y).isMine) ++mines;
+    return mines;
+}
+
+void TestSeededPlacementIsReproducible() {
+    Board a(30,16,99,12345), b(30,16,99,12345);
+    a.revealCell(10,8);
+    b.revealCell(10,8);
+    int differences = 0;
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 30; ++x)
+            if (a.getCell(x,y).isMine != b.getCell(x,y).isMine) ++differences;
+    EXPECT_EQ(differences, 0);
+    EXPECT_EQ(CountMines(a), 99);
+    EXPECT_EQ(a.getSeed(), 12345ull);
+}
+
+void TestSafeZoneAroundFirstClick() {
+    Board b(9,9,60,7);
+    b.revealCell(4,4);
+    for (int y = 3; y <= 5; ++y)
+        for (int x = 3; x <= 5; ++x)
+            EXPECT_FALSE(b.getCell(x,y).isMine);
+    EXPECT_EQ(CountMines(b), 60);
+    EXPECT_FALSE(b.getIsGameOver());
+}
+
+void TestDenseBoardPlacement() {
+    // Too dense for a 3x3 safe zone: only the clicked cell stays clear
+    Board b(9,9,80,99);
+    b.revealCell(0,0);
+    EXPECT_EQ(CountMines(b), 80);
+    EXPECT_FALSE(b.getCell(0,0).isMine);
+    EXPECT_TRUE(b.getIsGameWon());
+
+    // Above 25% the layout is counted by a rescan; moving mines off an edge click must not touch the border
+    int outside = 0, miscounted = 0;
+    for (uint64_t seed = 1; seed <= 50; ++seed) {
+        Board dense(10,10,40,seed);
+        dense.revealCell(0, static_cast<int>(seed % 10));
+        for (int index : dense.getChangedCells()) {
+            const int x = dense.cellX(index), y = dense.cellY(index);
+            if (x < 0 || x >= 10 || y < 0 || y >= 10) ++outside;
+        }
+        int revealed = 0;
+        for (int y = 0; y < 10; ++y) for (int x = 0; x < 10; ++x) revealed += dense.getCell(x,y).isRevealed;
+        if (revealed != dense.getCellsRevealed()) ++miscounted;
+    }
+    EXPECT_EQ(outside, 0);
+    EXPECT_EQ(miscounted, 0);
+}
+
+void TestSolverDeductionsAreSound() {
+    // The solver only plays proved moves, so it must never hit a mine
+    int wins = 0;
+    for (uint64_t seed = 1; seed <= 50; ++seed) {
+        Board b(30,16,99,seed);
+        Solver solver(b);
+        if (solver.solve()) ++wins;
+        EXPECT_FALSE(b.getIsGameOver() && !b.getIsGameWon());
+    }
+    for (uint64_t seed = 1; seed <= 50; ++seed) {
+        Board b(9,9,10,seed);
+        Solver solver(b);
+        if (solver.solve()) ++wins;
+        EXPECT_FALSE(b.getIsGameOver() && !b.getIsGameWon());
+    }
+    EXPECT_TRUE(wins > 0);
+}
+
+void TestSolverReportsProvedCells() {
+    Board b(16,16,40,2024);
+    Solver solver(b);
+    solver.reveal(8,8);
+    solver.analyze();
+    for (const CellCoord& c : solver.getMineCells()) EXPECT_TRUE(b.getCell(c.x,c.y).isMine);
+    for (const CellCoord& c : solver.getSafeCells()) EXPECT_FALSE(b.getCell(c.x,c.y).isMine);
+}
+
+// Counts layouts of the remaining mines over the hidden cells that agree with every revealed number
+static void BruteForceLayouts(const Board& b, const std::vector<int>& hidden, size_t next, int minesLeft,
+                              std::vector<int>& mines, double& layouts, std::vector<double>& mineCounts) {
+    const int w = b.getWidth(), h = b.getHeight();
+    if (minesLeft == 0 || next == hidden.size()) {
+        if (minesLeft != 0) return;
+        std::vector<int> isMine(w * h, 0);
+        for (int m : mines) isMine[m] = 1;
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x) {
+                Cell c = b.getCell(x,y);
+                if (!c.isRevealed) continue;
+                int around = 0;
+                for (int ny = y - 1; ny <= y + 1; ++ny)
+                    for (int nx = x - 1; nx <= x + 1; ++nx)
+                        if (nx >= 0 && nx < w && ny >= 0 && ny < h && isMine[ny * w + nx]) ++around;
+                if (around != c.adjacentMines) return;
+            }
+        layouts += 1.0;
+        for (int m : mines) mineCounts[m] += 1.0;
+        return;
+    }
+    if (static_cast<int>(hidden.size() - next) < minesLeft) return;
+    mines.push_back(hidden[next]);
+    BruteForceLayouts(b, hidden, next + 1, minesLeft - 1, mines, layouts, mineCounts);
+    mines.pop_back();
+    BruteForceLayouts(b, hidden, next + 1, minesLeft, mines, layouts, mineCounts);
+}
+
+void TestProbabilitiesMatchBruteForce() {
+    ProbabilityEngine engine(2);
+    int checked = 0;
+    for (uint64_t seed = 1; seed < 200 && checked < 5; ++seed) {
+        Board b(6,5,7,seed);
+        b.revealCell(0,0);
+        std::vector<int> hidden;
+        for (int i = 0; i < 30; ++i) if (!b.getCell(i % 6, i / 6).isRevealed) hidden.push_back(i);
+        if (b.getIsGameOver() || hidden.size() > 22) continue;
+        ++checked;
+
+        std::vector<double> p;
+        EXPECT_TRUE(engine.compute(b, p));
+        std::vector<int> mines;
+        std::vector<double> counts(30, 0.0);
+        double layouts = 0.0;
+        BruteForceLayouts(b, hidden, 0, b.getMineCount(), mines, layouts, counts);
+        int wrong = 0;
+        for (int i : hidden) if (std::fabs(p[i] - counts[i] / layouts) > 1e-9) ++wrong;
+        EXPECT_EQ(wrong, 0);
+    }
+    EXPECT_TRUE(checked > 0);
+}
+
+void TestProbabilitiesSumToMines() {
+    ProbabilityEngine engine;
+    Board b(30,16,99,77);
+    Solver solver(b);
+    solver.solve();
+    std::vector<double> p;
+    EXPECT_TRUE(engine.compute(b, p));
+    double sum = 0.0;
+    for (double v : p) sum += v;
+    EXPECT_TRUE(std::fabs(sum - 99.0) < 1e-6);
+}
+
+void TestGenerateWithoutReveal() {
+    Board b(16,16,40,5);
+    b.generate(3,3);
+    EXPECT_EQ(CountMines(b), 40);
+    EXPECT_EQ(b.getCellsRevealed(), 0);
+    EXPECT_FALSE(b.getCell(3,3).isMine);
+    // The next reveal plays on the generated layout instead of placing mines again
+    Board same(16,16,40,5);
+    same.revealCell(3,3);
+    b.revealCell(3,3);
+    EXPECT_EQ(b.getCellsRevealed(), same.getCellsRevealed());
+}
+
+void TestChangedCellsPerAction() {
+    Board b(30,16,99,11);
+    b.revealCell(15,8);
+    EXPECT_EQ(static_cast<int>(b.getChangedCells().size()), b.getCellsRevealed());
+    for (int index : b.getChangedCells()) EXPECT_TRUE(b.getCell(b.cellX(index), b.cellY(index)).isRevealed);
+
+    // The next action starts a fresh list
+    int x = 0, y = 0;
+    while (b.getCell(x,y).isRevealed) { if (++x == 30) { x = 0; ++y; } }
+    b.toggleFlag(x,y);
+    EXPECT_EQ(b.getChangedCells().size(), static_cast<size_t>(1));
+    EXPECT_EQ(b.getChangedCells()[0], b.cellIndex(x,y));
+}
+
+void TestChunkedBoardLayout() {
+    // 150x100 leaves partial chunks on the right and bottom edges
+    ChunkedBoard b(150,100,2000,21);
+    EXPECT_EQ(b.getChunkCount(), static_cast<size_t>(0));
+    b.revealCell(70,70);
+    EXPECT_FALSE(b.getIsGameOver());
+    long long mines = 0;
+    for (int y = 0; y < 100; ++y) for (int x = 0; x < 150; ++x) mines += b.hasMine(x,y);
+    EXPECT_EQ(mines, 2000LL);
+    for (int y = 69; y <= 71; ++y) for (int x = 69; x <= 71; ++x) EXPECT_FALSE(b.hasMine(x,y));
+
+    // Revealed counts agree with the mines, including across chunk edges
+    bool countsMatch = true;
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 150; ++x) {
+            Cell c = b.getCell(x,y);
+            if (!c.isRevealed) continue;
+            int expected = 0;
+            for (int ny = y - 1; ny <= y + 1; ++ny) for (int nx = x - 1; nx <= x + 1; ++nx) {
+                if ((nx != x || ny != y) && b.hasMine(nx,ny)) ++expected;
+            }
+            countsMatch = countsMatch && c.adjacentMines == expected && !c.isMine;
+        }
+    }
+    EXPECT_TRUE(countsMatch);
+
+    // Same seed and first click give the same layout
+    ChunkedBoard same(150,100,2000,21);
+    same.revealCell(70,70);
+    EXPECT_EQ(same.getCellsRevealed(), b.getCellsRevealed());
+    bool identical = true;
+    for (int y = 0; y < 100; ++y) for (int x = 0; x < 150; ++x) identical = identical && same.hasMine(x,y) == b.hasMine(x,y);
+    EXPECT_TRUE(identical);
+}
+
+void TestChunkedBoardMineHitNeverWins() {
+    // A 4x1 board clicked at its right end keeps the mine at 0 or 1; with it at 1, cell 0 is the last safe cell
+    uint64_t seed = 0;
+    while (true) {
+        ChunkedBoard probe(4,1,1,seed);
+        probe.revealCell(3,0);
+        if (probe.hasMine(1,0)) break;
+        ++seed;
+    }
+    ChunkedBoard b(4,1,1,seed);
+    b.revealCell(3,0);
+    EXPECT_EQ(b.getCellsRevealed(), 2LL);
+    b.revealCell(1,0);
+    EXPECT_TRUE(b.getIsGameOver());
+    EXPECT_FALSE(b.getIsGameWon());
+    EXPECT_EQ(b.getCellsRevealed(), 2LL);
+}
+
+void TestChunkedBoardHuge() {
+    // 100k x 100k only allocates the chunks play has reached
+    ChunkedBoard b(100000,100000,1500000000LL,3);
+    b.toggleFlag(5,5);
+    EXPECT_EQ(b.getFlagsPlaced(), 1LL);
+    b.revealCell(50000,50000);
+    EXPECT_FALSE(b.getIsGameOver());
+    EXPECT_TRUE(b.getCell(50000,50000).isRevealed);
+    EXPECT_TRUE(b.getChunkCount() < static_cast<size_t>(64));
+    EXPECT_FALSE(b.getCell(99999,99999).isRevealed);
+    b.resetBoard(4);
+    EXPECT_EQ(b.getChunkCount(), static_cast<size_t>(0));
+    EXPECT_EQ(b.getFlagsPlaced(), 0LL);
+}
+
+void TestInfiniteBoardEviction() {
+    InfiniteBoard b(0.2,8,16);
+    b.revealCell(-1,-1);
+    EXPECT_FALSE(b.getIsGameOver());
+    const long long opened = b.getCellsRevealed();
+    EXPECT_TRUE(opened >= 9);
+
+    // Counts near the origin (spanning four chunks) agree with the mines around them
+    bool countsMatch = true;
+    for (long long y = -40; y < 40; ++y) {
+        for (long long x = -40; x < 40; ++x) {
+            Cell c = b.getCell(x,y);
+            if (!c.isRevealed) continue;
+            int expected = 0;
+            for (long long ny = y - 1; ny <= y + 1; ++ny) for (long long nx = x - 1; nx <= x + 1; ++nx) {
+                if ((nx != x || ny != y) && b.getCell(nx,ny).isMine) ++expected;
+            }
+            countsMatch = countsMatch && c.adjacentMines == expected && !c.isMine;
+        }
+    }
+    EXPECT_TRUE(countsMatch);
+
+    // Play far away until the opening is evicted; its state survives as a bitmap and is replayed
+    for (long long i = 1; i <= 40; ++i) {
+        long long x = i * 1000, y = 0;
+        while (b.getCell(x,y).isMine) ++y;
+        b.revealCell(x,y);
+    }
+    EXPECT_FALSE(b.getIsGameOver());
+    EXPECT_TRUE(b.getCachedChunkCount() <= static_cast<size_t>(16));
+    EXPECT_TRUE(b.getSavedChunkCount() > static_cast<size_t>(0));
+    EXPECT_TRUE(b.getCell(-1,-1).isRevealed);
+    b.toggleFlag(-1,-1);
+    EXPECT_EQ(b.getFlagsPlaced(), 0LL);
+    b.revealCell(-1,-1);
+    EXPECT_TRUE(b.getCellsRevealed() > opened);
+}
+
+void TestSnapshotRoundTrip() {
+    // 70 columns: one full 64-bit word per row plus a partial one
+    Board b(70,40,300,17);
+    b.revealCell(35,20);
+    int flagX = 0, flagY = 0;
+    while (b.getCell(flagX,flagY).isRevealed) { if (++flagX == 70) { flagX = 0; ++flagY; } }
+    b.toggleFlag(flagX,flagY);
+    SnapshotInfo info;
+    info.secondsElapsed = 42;
+    info.timerRunning = true;
+    const char* path = "snapshot_test.sav";
+    EXPECT_TRUE(BoardSnapshot::save(path, b, info));
+
+    {
+        BoardSnapshot snapshot(path);
+        EXPECT_TRUE(snapshot.isValid());
+        EXPECT_EQ(snapshot.getWidth(), 70);
+        EXPECT_EQ(snapshot.getSeed(), static_cast<uint64_t>(17));
+        EXPECT_EQ(snapshot.getInfo().secondsElapsed, 42);
+        EXPECT_TRUE(snapshot.getInfo().timerRunning);
+
+        Board restored(snapshot.getWidth(), snapshot.getHeight(), snapshot.getMineCount());
+        EXPECT_TRUE(snapshot.restore(restored));
+        bool same = true;
+        for (int y = 0; y < 40; ++y) for (int x = 0; x < 70; ++x) {
+            Cell c = b.getCell(x,y), r = restored.getCell(x,y);
+            same = same && c.isMine == r.isMine && c.isRevealed == r.isRevealed && c.isFlagged == r.isFlagged && c.adjacentMines == r.adjacentMines;
+        }
+        EXPECT_TRUE(same);
+        EXPECT_EQ(restored.getCellsRevealed(), b.getCellsRevealed());
+        EXPECT_EQ(restored.getFlagsPlaced(), 1);
+        EXPECT_EQ(restored.getMineCount(), 300);
+        EXPECT_FALSE(restored.getIsGameOver());
+
+        // A board of the wrong size is refused
+        Board other(9,9,10);
+        EXPECT_FALSE(snapshot.restore(other));
+    }
+    std::remove(path);
+    EXPECT_FALSE(BoardSnapshot(path).isValid());
+}
+
+static bool SameCells(const Board& a, const Board& b) {
+    for (int y = 0; y < a.getHeight(); ++y) for (int x = 0; x < a.getWidth(); ++x) {
+        Cell c = a.getCell(x,y), d = b.getCell(x,y);
+        if (c.isMine != d.isMine || c.isRevealed != d.isRevealed || c.isFlagged != d.isFlagged || c.adjacentMines != d.adjacentMines) return false;
+    }
+    return true;
+}
+
+void TestActionLogReplay() {
+    Board played(30,16,99,23);
+    ActionLog log;
+    played.setRecorder(&log);
+    Solver solver(played);
+    // Guess the first undecided cell whenever the solver is stuck, until the game ends
+    while (!solver.solve() && !played.getIsGameOver()) {
+        int x = 0, y = 0;
+        while (played.getCell(x,y).isRevealed || solver.isKnownMine(x,y)) { if (++x == 30) { x = 0; ++y; } }
+        solver.reveal(x,y);
+    }
+    played.toggleFlag(0,0);
+    played.toggleFlag(0,0);
+    EXPECT_TRUE(log.size() > static_cast<size_t>(10));
+    EXPECT_TRUE(log.byteSize() <= log.size() * 4);
+
+    // The log survives a round trip through a file
+    const char* path = "replay_test.mlog";
+    EXPECT_TRUE(log.save(path));
+    ActionLog loaded;
+    EXPECT_TRUE(loaded.load(path));
+    std::remove(path);
+    EXPECT_EQ(loaded.size(), log.size());
+    EXPECT_EQ(loaded.getSeed(), static_cast<uint64_t>(23));
+
+    Board board(30,16,99);
+    Replay replay(loaded, board, 16);
+    EXPECT_EQ(replay.fastForward(), loaded.size());
+    EXPECT_TRUE(replay.atEnd());
+    EXPECT_TRUE(SameCells(board, played));
+    EXPECT_EQ(board.getCellsRevealed(), played.getCellsRevealed());
+    EXPECT_EQ(board.getIsGameWon(), played.getIsGameWon());
+
+    // Seeking back lands on a keyframe and must match a straight replay to the same point
+    const size_t middle = loaded.size() / 2 + 3;
+    Board straight(30,16,99);
+    Replay reference(loaded, straight);
+    reference.fastForward(middle);
+    replay.seek(middle);
+    EXPECT_EQ(replay.getPosition(), middle);
+    EXPECT_TRUE(SameCells(board, straight));
+    EXPECT_EQ(board.getFlagsPlaced(), straight.getFlagsPlaced());
+    replay.seek(0);
+    EXPECT_EQ(board.getCellsRevealed(), 0);
+}
+
+void TestUndoRedo() {
+    // A large opening is undone and redone from its own delta
+    Board b(1000,1000,100,31);
+    b.setUndoLimit(8);
+    Board reference(1000,1000,100,31);
+    b.revealCell(500,500);
+    reference.revealCell(500,500);
+    const int opened = b.getCellsRevealed();
+    EXPECT_TRUE(opened > 100000);
+    EXPECT_TRUE(b.undo());
+    EXPECT_EQ(static_cast<int>(b.getChangedCells().size()), opened);
+    EXPECT_EQ(b.getCellsRevealed(), 0);
+    EXPECT_FALSE(b.getCell(500,500).isRevealed);
+    EXPECT_FALSE(b.canUndo());
+    EXPECT_TRUE(b.redo());
+    EXPECT_EQ(b.getCellsRevealed(), opened);
+    EXPECT_TRUE(SameCells(b, reference));
+
+    // Flags undo too, and a new move drops the redo history
+    int x = 0, y = 0;
+    while (b.getCell(x,y).isRevealed) { if (++x == 1000) { x = 0; ++y; } }
+    b.toggleFlag(x,y);
+    EXPECT_TRUE(b.undo());
+    EXPECT_FALSE(b.getCell(x,y).isFlagged);
+    EXPECT_EQ(b.getFlagsPlaced(), 0);
+    EXPECT_TRUE(b.canRedo());
+    b.toggleFlag(x,y);
+    EXPECT_FALSE(b.canRedo());
+
+    // Only the last depth moves are kept
+    Board small(9,9,10,5);
+    small.setUndoLimit(2);
+    small.toggleFlag(0,0);
+    small.toggleFlag(1,0);
+    small.toggleFlag(2,0);
+    EXPECT_TRUE(small.undo());
+    EXPECT_TRUE(small.undo());
+    EXPECT_FALSE(small.undo());
+    EXPECT_EQ(small.getFlagsPlaced(), 1);
+
+    // Undo and redo are recorded and replay to the same position
+    Board played(16,16,40,9);
+    played.setUndoLimit(100);
+    ActionLog log;
+    played.setRecorder(&log);
+    played.revealCell(8,8);
+    played.undo();
+    played.revealCell(2,2);
+    played.toggleFlag(15,15);
+    played.undo();
+    played.redo();
+    Board replayed(16,16,40);
+    replayed.setUndoLimit(7, 500);
+    {
+        Replay replay(log, replayed, 2);
+        replay.fastForward();
+        EXPECT_TRUE(SameCells(replayed, played));
+        replay.seek(3);
+        replay.fastForward();
+        EXPECT_TRUE(SameCells(replayed, played));
+    }
+    // The replay lifts the limit only while it runs
+    EXPECT_EQ(replayed.getUndoDepth(), 7);
+    EXPECT_EQ(replayed.getUndoMaxCells(), static_cast<size_t>(500));
+
+    // Lowering the limit forgets the oldest moves right away
+    Board trimmed(16,16,40,3);
+    trimmed.setUndoLimit(10);
+    for (int i = 0; i < 6; ++i) trimmed.toggleFlag(i, 15);
+    trimmed.setUndoLimit(2);
+    EXPECT_TRUE(trimmed.undo());
+    EXPECT_TRUE(trimmed.undo());
+    EXPECT_FALSE(trimmed.undo());
+
+    // Undoing the first click over and over must not leave counts piling up in the border ring
+    Board cycled(9,9,10,42), fresh(9,9,10,42);
+    cycled.setUndoLimit(100);
+    fresh.revealCell(4,4);
+    int drifted = 0;
+    for (int i = 0; i < 300; ++i) {
+        cycled.revealCell(4,4);
+        if (!SameCells(cycled, fresh) || cycled.getCellsRevealed() != fresh.getCellsRevealed()) ++drifted;
+        cycled.undo();
+    }
+    EXPECT_EQ(drifted, 0);
+}
+
+void TestNoGuessGenerator() {
+    // Expert boards: the chosen layout is solved from the first click without a guess
+    NoGuessGenerator serial(1), parallel(4);
+    uint64_t seed = 0, parallelSeed = 1;
+    EXPECT_TRUE(serial.findSeed(30,16,99,3,4,77,seed));
+    Board board(30,16,99,seed);
+    Solver solver(board);
+    solver.reveal(3,4);
+    EXPECT_TRUE(solver.solve());
+    EXPECT_TRUE(board.getIsGameWon());
+
+    // The winner is the lowest qualifying candidate, whatever the thread count
+    EXPECT_TRUE(parallel.findSeed(30,16,99,3,4,77,parallelSeed));
+    EXPECT_EQ(parallelSeed, seed);
+
+    // Too few attempts for a board this dense reports failure
+    EXPECT_FALSE(serial.findSeed(9,9,60,4,4,77,seed,8));
+
+    // Boards past the size limit are refused before any candidate is laid out
+    EXPECT_FALSE(parallel.findSeed(2000,1000,100000,5,5,77,seed));
+    EXPECT_EQ(parallel.getAttempts(), 0);
+}
+
+void TestPrefetchedReset() {
+    // A prefetched layout is the same one resetBoard(seed) builds in place
+    Board prefetched(64,48,500);
+    prefetched.setPrefetch(true);
+    for (int game = 0; game < 3; ++game) {
+        prefetched.toggleFlag(0,0);
+        prefetched.resetBoard();
+        EXPECT_EQ(prefetched.getFlagsPlaced(), 0);
+        Board direct(64,48,500,prefetched.getSeed());
+        prefetched.revealCell(10,20);
+        direct.revealCell(10,20);
+        EXPECT_TRUE(SameCells(prefetched, direct));
+    }
+
+    // Mines are not visible before the first click, and the click still lands in an opening
+    prefetched.resetBoard();
+    int visible = 0;
+    for (int y = 0; y < 48; ++y)
+        for (int x = 0; x < 64; ++x)
+            visible += prefetched.getCell(x,y).isMine ? 1 : 0;
+    EXPECT_EQ(visible, 0);
+    prefetched.revealCell(63,47);
+    EXPECT_FALSE(prefetched.getIsGameOver());
+    EXPECT_EQ(prefetched.getCell(63,47).adjacentMines, 0);
+    prefetched.setPrefetch(false);
+}
+
+// Keeps a copy of every batch the board publishes
+struct EventRecorder : BoardListener {
+    std::vector<BoardEvent> last;
+    int batches = 0;
+    int wins = 0;
+    void onBoardEvents(const Board&, const BoardEvent* events, size_t count) override {
+        last.assign(events, events + count);
+        ++batches;
+        for (size_t i = 0; i < count; ++i) wins += events[i].type == EVENT_GAME_WON ? 1 : 0;
+    }
+    int countOf(BoardEventType type) const {
+        int n = 0;
+        for (const BoardEvent& e : last) n += e.type == type ? 1 : 0;
+        return n;
+    }
+};
+
+void TestBoardEvents() {
+    Board board(30,16,99,21);
+    board.setUndoLimit(100);
+    EventRecorder events;
+    board.addListener(&events);
+
+    // One batch per action; the opening is a single range over the changed cells
+    board.revealCell(15,8);
+    EXPECT_EQ(events.batches, 1);
+    EXPECT_EQ(events.countOf(EVENT_CELLS_REVEALED), 1);
+    EXPECT_EQ(events.countOf(EVENT_COUNTERS_CHANGED), 1);
+    EXPECT_EQ(events.last[0].count, static_cast<int>(board.getChangedCells().size()));
+
+    // Flags name their cell; a no-op action publishes nothing
+    int hx = -1, hy = -1, mx = -1, my = -1;
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 30; ++x) {
+            const Cell c = board.getCell(x,y);
+            if (!c.isRevealed && !c.isMine && hx < 0) { hx = x; hy = y; }
+            if (c.isMine && mx < 0) { mx = x; my = y; }
+        }
+    board.toggleFlag(hx,hy);
+    EXPECT_EQ(events.countOf(EVENT_FLAG_TOGGLED), 1);
+    EXPECT_EQ(events.last[0].x, hx);
+    board.toggleFlag(hx,hy);
+    board.toggleFlag(15,8);
+    EXPECT_EQ(events.batches, 3);
+
+    // Losing, undoing and redoing the losing move
+    board.revealCell(mx,my);
+    EXPECT_EQ(events.countOf(EVENT_MINE_HIT), 1);
+    EXPECT_EQ(events.last[1].x, mx);
+    EXPECT_EQ(events.last[1].y, my);
+    board.undo();
+    EXPECT_EQ(events.countOf(EVENT_CELLS_RESTORED), 1);
+    EXPECT_EQ(events.countOf(EVENT_GAME_RESUMED), 1);
+    board.redo();
+    EXPECT_EQ(events.countOf(EVENT_MINE_HIT), 1);
+    EXPECT_EQ(events.last[1].x, mx);
+
+    // A solved game is won exactly once
+    board.resetBoard(21);
+    EXPECT_EQ(events.countOf(EVENT_BOARD_RESET), 1);
+    Board solvable(9,9,10,3);
+    solvable.addListener(&events);
+    Solver solver(solvable);
+    while (!solver.solve() && !solvable.getIsGameOver()) {
+        for (int i = 0; i < 81; ++i) {
+            if (!solvable.getCell(i % 9, i / 9).isRevealed && !solver.isKnownMine(i % 9, i / 9)) { solver.reveal(i % 9, i / 9); break; }
+        }
+    }
+    EXPECT_EQ(events.wins, solvable.getIsGameWon() ? 1 : 0);
+
+    board.removeListener(&events);
+    const int before = events.batches;
+    board.revealCell(0,0);
+    EXPECT_EQ(events.batches, before);
+}
+
+// Frontier by a full scan, sorted, for comparison with the incremental index
+static std::vector<int> ScanFrontier(const Board& b) {
+    std::vector<int> cells;
+    for (int y = 0; y < b.getHeight(); ++y)
+        for (int x = 0; x < b.getWidth(); ++x) {
+            const Cell c = b.getCell(x,y);
+            if (c.isRevealed || c.isFlagged) continue;
+            bool nextToNumber = false;
+            for (int ny = y - 1; ny <= y + 1; ++ny)
+                for (int nx = x - 1; nx <= x + 1; ++nx) {
+                    if (nx < 0 || ny < 0 || nx >= b.getWidth() || ny >= b.getHeight()) continue;
+                    const Cell n = b.getCell(nx,ny);
+                    if (n.isRevealed && !n.isMine && n.adjacentMines > 0) nextToNumber = true;
+                }
+            if (nextToNumber) cells.push_back(b.cellIndex(x,y));
+        }
+    return cells;
+}
+
+static bool FrontierMatches(const Board& b) {
+    std::vector<int> tracked = b.getFrontier();
+    std::sort(tracked.begin(), tracked.end());
+    return tracked == ScanFrontier(b);
+}
+
+void TestFrontierIndex() {
+    Board board(40,30,200,5);
+    board.setUndoLimit(1000);
+    board.setFrontierTracking(true);
+    EXPECT_TRUE(board.getFrontier().empty());
+
+    // Random reveals, flags, chords and undo/redo keep the index equal to a full scan
+    Random rng(99);
+    int mismatches = 0;
+    for (int game = 0; game < 4; ++game) {
+        board.resetBoard(100 + game);
+        int moves = 0;
+        for (int move = 0; move < 300; ++move) {
+            if (board.getIsGameOver()) board.undo(); // Take back a loss (or win) so play goes on
+            const int x = static_cast<int>(rng.below(40));
+            const int y = static_cast<int>(rng.below(30));
+            switch (rng.below(6)) {
+                case 0: case 1: if (!board.getCell(x,y).isFlagged) board.revealCell(x,y); break;
+                case 2: board.toggleFlag(x,y); break;
+                case 3: board.chordCell(x,y); break;
+                case 4: board.undo(); break;
+                default: board.redo(); break;
+            }
+            if (!FrontierMatches(board)) ++mismatches;
+            moves += board.getFrontier().empty() ? 0 : 1;
+        }
+        EXPECT_TRUE(moves > 100);
+    }
+    EXPECT_EQ(mismatches, 0);
+
+    // Restoring planes rebuilds it; reset empties it
+    const int words = board.rowWords() * board.getHeight();
+    std::vector<uint64_t> planes(words * 3);
+    board.exportPlanes(planes.data(), planes.data() + words, planes.data() + 2 * words);
+    Board restored(40,30,200);
+    restored.setFrontierTracking(true);
+    restored.importPlanes(planes.data(), planes.data() + words, planes.data() + 2 * words, board.getSeed());
+    EXPECT_TRUE(FrontierMatches(restored));
+    board.resetBoard(7);
+    EXPECT_TRUE(board.getFrontier().empty());
+}
+
+// Lays out exactly the given mines (row-major strings, '*' = mine) through the snapshot planes
+static void LayOut(Board& b, const std::vector<std::string>& rows) {
+    const int words = b.rowWords() * b.getHeight();
+    std::vector<uint64_t> planes(words * 3, 0);
+    for (int y = 0; y < b.getHeight(); ++y)
+        for (int x = 0; x < b.getWidth(); ++x)
+            if (rows[y][x] == '*') planes[y * b.rowWords() + x / 64] |= 1ull << (x % 64);
+    b.importPlanes(planes.data(), planes.data() + words, planes.data() + 2 * words, 0);
+}
+
+void TestMineHitNeverWins() {
+    // Open every safe cell but one, then step on a mine: the game is lost, not won
+    Board b(8,8,10,1);
+    b.setUndoLimit(1);
+    b.revealCell(0,0);
+    for (int i = 0; i < 64; ++i) {
+        if (b.getCell(i % 8, i / 8).isMine) continue;
+        b.revealCell(i % 8, i / 8);
+        if (b.getIsGameWon()) b.undo(); // Take back the winning click
+    }
+    EXPECT_EQ(b.getCellsRevealed(), 8 * 8 - 10 - 1);
+    for (int i = 0; i < 64 && !b.getIsGameOver(); ++i)
+        if (b.getCell(i % 8, i / 8).isMine) b.revealCell(i % 8, i / 8);
+    EXPECT_TRUE(b.getIsGameOver());
+    EXPECT_FALSE(b.getIsGameWon());
+    EXPECT_EQ(b.getCellsRevealed(), 8 * 8 - 10 - 1);
+
+    // A chord around a wrong flag detonates the mine it left out
+    Board chord(3,1,1);
+    LayOut(chord, { "*.." });
+    chord.revealCell(1,0);
+    chord.toggleFlag(2,0);
+    chord.chordCell(1,0);
+    EXPECT_TRUE(chord.getIsGameOver());
+    EXPECT_FALSE(chord.getIsGameWon());
+}
+
+void TestBoardMetrics() {
+    BoardAnalyzer analyzer(2);
+
+    // One mine in the middle: the zero ring is one opening that uncovers every number
+    Board ring(5,5,1);
+    LayOut(ring, { ".....", ".....", "..*..", ".....", "....." });
+    BoardMetrics m = analyzer.analyze(ring);
+    EXPECT_EQ(m.openings, 1);
+    EXPECT_EQ(m.isolatedNumbers, 0);
+    EXPECT_EQ(m.bbbv, 1);
+
+    // No zeros at all: every number is its own click; touching numbers form one island
+    Board strip(6,1,3);
+    LayOut(strip, { "*.*..*" });
+    m = analyzer.analyze(strip);
+    EXPECT_EQ(m.openings, 0);
+    EXPECT_EQ(m.isolatedNumbers, 3);
+    EXPECT_EQ(m.islands, 2);
+    EXPECT_EQ(m.bbbv, 3);
+
+    // Two openings split by a wall of mines, plus a corner number no opening reaches
+    Board split(9,3,6);
+    LayOut(split, { "..*....**", "..*....*.", "..*......" });
+    m = analyzer.analyze(split);
+    EXPECT_EQ(m.openings, 2);
+    EXPECT_EQ(m.isolatedNumbers, 3);
+    EXPECT_EQ(m.islands, 1);
+    EXPECT_EQ(m.bbbv, 5);
+
+    // Batch results match boards laid out one at a time, whatever the thread count
+    std::vector<uint64_t> seeds;
+    for (uint64_t s = 1; s <= 600; ++s) seeds.push_back(s * 7919);
+    std::vector<BoardMetrics> batch;
+    analyzer.analyzeSeeds(30,16,99,15,8,seeds,batch);
+    EXPECT_EQ(batch.size(), seeds.size());
+    int mismatches = 0;
+    for (size_t i = 0; i < seeds.size(); i += 97) {
+        Board board(30,16,99,seeds[i]);
+        board.generate(15,8);
+        const BoardMetrics single = analyzer.analyze(board);
+        if (single.bbbv != batch[i].bbbv || single.openings != batch[i].openings || single.islands != batch[i].islands) ++mismatches;
+        if (batch[i].bbbv < 1 || batch[i].islands > batch[i].isolatedNumbers) ++mismatches;
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+void TestOpeningLabels() {
+    // Labeled and flood-filled boards stay identical through reveals, flags, chords and undo/redo
+    Board labeled(50,40,150,8), flooded(50,40,150,8);
+    labeled.setOpeningLabels(true);
+    labeled.setUndoLimit(1000);
+    flooded.setUndoLimit(1000);
+    labeled.revealCell(25,20);
+    flooded.revealCell(25,20);
+    EXPECT_TRUE(labeled.getOpeningCount() > 1);
+    BoardAnalyzer analyzer(1);
+    EXPECT_EQ(labeled.getOpeningCount(), analyzer.analyze(labeled).openings);
+
+    Random rng(4);
+    int mismatches = 0;
+    for (int move = 0; move < 2000; ++move) {
+        if (labeled.getIsGameOver()) { labeled.undo(); flooded.undo(); }
+        const int x = static_cast<int>(rng.below(50));
+        const int y = static_cast<int>(rng.below(40));
+        switch (rng.below(8)) {
+            case 0: labeled.toggleFlag(x,y); flooded.toggleFlag(x,y); break;
+            case 1: labeled.chordCell(x,y); flooded.chordCell(x,y); break;
+            case 2: labeled.undo(); flooded.undo(); break;
+            case 3: labeled.redo(); flooded.redo(); break;
+            default:
+                if (!labeled.getCell(x,y).isFlagged) { labeled.revealCell(x,y); flooded.revealCell(x,y); }
+                break;
+        }
+        if (!SameCells(labeled, flooded) || labeled.getCellsRevealed() != flooded.getCellsRevealed()) ++mismatches;
+        if (labeled.getChangedCells().size() != flooded.getChangedCells().size()) ++mismatches;
+    }
+    EXPECT_EQ(mismatches, 0);
+
+    // A new game drops the labels until its first click
+    labeled.resetBoard(9);
+    EXPECT_EQ(labeled.getOpeningCount(), 0);
+    labeled.revealCell(0,0);
+    EXPECT_TRUE(labeled.getOpeningCount() > 0);
+}
+
+static std::string Run(GameProtocol& protocol, const std::string& line) {
+    std::string out;
+    protocol.execute(line.data(), line.size(), out);
+    return out;
+}
+
+void TestGameProtocol() {
+    GameProtocol protocol;
+    EXPECT_EQ(Run(protocol, "R 0 0"), std::string("e no game; start one with N\n"));
+    EXPECT_EQ(Run(protocol, "N 0 9 10"), std::string("e bad board size or mine count\n"));
+    EXPECT_EQ(Run(protocol, "N 9 9 10 5"), std::string("p 5\n"));
+    EXPECT_EQ(Run(protocol, "X"), std::string("e unknown command\n"));
+    EXPECT_EQ(Run(protocol, "R 9 0"), std::string("e cell out of range\n"));
+    EXPECT_EQ(Run(protocol, "R 4"), std::string("e expected x y\n"));
+
+    // Replies mirror the board driven directly with the same seed
+    Board board(9,9,10,5);
+    board.revealCell(4,4);
+    const std::string reveal = Run(protocol, "R 4 4");
+    EXPECT_EQ(reveal.substr(0, 2 + std::to_string(board.getChangedCells().size()).size()),
+              "p " + std::to_string(board.getChangedCells().size()));
+    int hidden = 0;
+    while (board.getCell(hidden % 9, hidden / 9).isRevealed) ++hidden;
+    const std::string cell = std::to_string(hidden % 9) + " " + std::to_string(hidden / 9);
+    EXPECT_EQ(Run(protocol, "F " + cell), "p 1 " + cell + " F\n");
+    EXPECT_EQ(Run(protocol, "R " + cell), std::string("p 0\n"));
+    board.toggleFlag(hidden % 9, hidden / 9);
+
+    std::string expected = "p 9 9 ";
+    for (int y = 0; y < 9; ++y)
+        for (int x = 0; x < 9; ++x) {
+            const Cell c = board.getCell(x,y);
+            expected.push_back(c.isRevealed ? static_cast<char>('0' + c.adjacentMines) : c.isFlagged ? 'F' : '.');
+        }
+    EXPECT_EQ(Run(protocol, "S"), expected + "\n");
+
+    // Same size and mine count reuse the board for the new seed
+    EXPECT_EQ(Run(protocol, "N 9 9 10 6"), std::string("p 6\n"));
+    EXPECT_EQ(Run(protocol, "S"), "p 9 9 " + std::string(81, '.') + "\n");
+    EXPECT_FALSE(protocol.isClosed());
+    EXPECT_EQ(Run(protocol, "Q"), std::string("bye\n"));
+    EXPECT_TRUE(protocol.isClosed());
+}
+
+static bool SamePlanes(const Board& board, const SharedBoard& shared) {
+    const size_t words = static_cast<size_t>(board.rowWords()) * board.getHeight();
+    std::vector<uint64_t> a(words * 3), b(words * 3);
+    board.exportPlanes(a.data(), a.data() + words, a.data() + 2 * words);
+    shared.exportPlanes(b.data(), b.data() + words, b.data() + 2 * words);
+    return a == b;
+}
+
+// Runs body(thread) on threads threads at once
+template <class Body>
+static void RunThreads(int threads, Body body) {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) pool.emplace_back(body, t);
+    for (std::thread& thread : pool) thread.join();
+}
+
+void TestSharedBoardStress() {
+    // Many threads flood the same large board from overlapping clicks; the result must match one thread
+    const int side = 4000, threads = 8;
+    Board reference(side, side, side * side / 100, 11);
+    reference.generate(side / 2, side / 2);
+    SharedBoard shared(reference);
+    EXPECT_EQ(shared.getCellsRevealed(), 0);
+
+    Random rng(12);
+    std::vector<std::pair<int,int>> clicks;
+    while (clicks.size() < 4096) {
+        const int x = static_cast<int>(rng.below(side)), y = static_cast<int>(rng.below(side));
+        if (!reference.getCell(x,y).isMine) clicks.push_back({ x, y });
+    }
+    // Every thread makes every click, each starting at a different point, so floods race and cross everywhere
+    std::atomic<long long> returned(0);
+    RunThreads(threads, [&](int t) {
+        long long mine = 0;
+        for (size_t i = 0; i < clicks.size(); ++i) {
+            const auto& c = clicks[(i + t * clicks.size() / threads) % clicks.size()];
+            mine += shared.revealCell(c.first, c.second);
+        }
+        returned += mine;
+    });
+    for (const auto& c : clicks) reference.revealCell(c.first, c.second);
+    EXPECT_TRUE(SamePlanes(reference, shared));
+    EXPECT_EQ(shared.getCellsRevealed(), reference.getCellsRevealed());
+    EXPECT_EQ(returned.load(), static_cast<long long>(reference.getCellsRevealed()));
+    EXPECT_FALSE(shared.getIsGameOver());
+
+    // An even number of toggles per cell leaves no flags, and no toggle is lost
+    std::vector<std::pair<int,int>> hidden;
+    while (hidden.size() < 2000) {
+        const int x = static_cast<int>(rng.below(side)), y = static_cast<int>(rng.below(side));
+        if (!reference.getCell(x,y).isRevealed) hidden.push_back({ x, y });
+    }
+    returned = 0;
+    RunThreads(threads, [&](int) {
+        for (const auto& h : hidden) returned += shared.toggleFlag(h.first, h.second);
+    });
+    EXPECT_EQ(returned.load(), static_cast<long long>(threads * hidden.size()));
+    EXPECT_EQ(shared.getFlagsPlaced(), 0);
+    EXPECT_TRUE(SamePlanes(reference, shared));
+
+    // Chords around correctly flagged numbers, run concurrently, open the same cells as sequential chords
+    std::vector<std::pair<int,int>> numbers;
+    for (const auto& c : clicks) {
+        for (int dy = -3; dy <= 3 && numbers.size() < 3000; ++dy)
+            for (int dx = -3; dx <= 3; ++dx) {
+                const int x = c.first + dx, y = c.second + dy;
+                if (x < 0 || y < 0 || x >= side || y >= side) continue;
+                const Cell cell = reference.getCell(x,y);
+                if (!cell.isRevealed || cell.adjacentMines == 0) continue;
+                for (int ny = y - 1; ny <= y + 1; ++ny)
+                    for (int nx = x - 1; nx <= x + 1; ++nx)
+                        if (nx >= 0 && ny >= 0 && nx < side && ny < side && reference.getCell(nx,ny).isMine && !reference.getCell(nx,ny).isFlagged) {
+                            reference.toggleFlag(nx,ny);
+                            shared.toggleFlag(nx,ny);
+                        }
+                numbers.push_back({ x, y });
+            }
+    }
+    EXPECT_EQ(shared.getFlagsPlaced(), reference.getFlagsPlaced());
+    RunThreads(threads, [&](int t) {
+        for (size_t i = t; i < numbers.size(); i += threads) shared.chordCell(numbers[i].first, numbers[i].second);
+    });
+    for (const auto& n : numbers) reference.chordCell(n.first, n.second);
+    EXPECT_TRUE(SamePlanes(reference, shared));
+    EXPECT_EQ(shared.getCellsRevealed(), reference.getCellsRevealed());
+    EXPECT_FALSE(shared.getIsGameOver());
+
+    // Threads racing to reveal every safe cell win exactly once; a mine then ends the game
+    Board small(200, 200, 4000, 13);
+    small.generate(0, 0);
+    SharedBoard race(small);
+    RunThreads(threads, [&](int t) {
+        for (int i = 0; i < 200 * 200; ++i) {
+            const int cell = (i * 7919 + t * 5000) % (200 * 200);
+            if (!small.getCell(cell % 200, cell / 200).isMine) race.revealCell(cell % 200, cell / 200);
+        }
+    });
+    EXPECT_EQ(race.getCellsRevealed(), 200 * 200 - 4000);
+    EXPECT_TRUE(race.getIsGameWon());
+    EXPECT_TRUE(race.getIsGameOver());
+    SharedBoard lost(small);
+    int mx = 0;
+    while (!small.getCell(mx, 199).isMine) ++mx;
+    EXPECT_EQ(lost.revealCell(mx, 199), 1);
+    EXPECT_TRUE(lost.getIsGameOver());
+    EXPECT_FALSE(lost.getIsGameWon());
+    EXPECT_EQ(lost.getCellsRevealed(), 0);
+
+    // Setting off a mine with one safe cell left loses too
+    Board nearly(3,1,1);
+    LayOut(nearly, { "*.." });
+    nearly.revealCell(1,0);
+    SharedBoard last(nearly);
+    EXPECT_EQ(last.revealCell(0,0), 1);
+    EXPECT_TRUE(last.getIsGameOver());
+    EXPECT_FALSE(last.getIsGameWon());
+    EXPECT_EQ(last.getCellsRevealed(), 1);
+}
+
+#ifdef __linux__
+static int ConnectLocal(int port) {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) { close(fd); return -1; }
+    return fd;
+}
+
+// Sends commands and reads until one reply line per command has arrived (or the server closes)
+static std::string Exchange(int fd, const std::string& commands) {
+    if (send(fd, commands.data(), commands.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(commands.size())) return "";
+    const long lines = std::count(commands.begin(), commands.end(), '\n');
+    std::string replies;
+    char buffer[4096];
+    while (std::count(replies.begin(), replies.end(), '\n') < lines) {
+        const ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        replies.append(buffer, static_cast<size_t>(n));
+    }
+    return replies;
+}
+
+void TestGameServer() {
+    GameServer server(2);
+    EXPECT_TRUE(server.listenTcp(0));
+    std::thread loop([&server]() { server.run(); });
+
+    // Sessions answer exactly like a local protocol, each with its own game, even when commands are pipelined
+    const std::string script = "N 9 9 10 5\nR 4 4\nF 0 0\nS\n";
+    GameProtocol local;
+    std::string expected;
+    for (size_t start = 0, end; (end = script.find('\n', start)) != std::string::npos; start = end + 1)
+        local.execute(script.data() + start, end - start, expected);
+
+    const int first = ConnectLocal(server.getTcpPort());
+    const int second = ConnectLocal(server.getTcpPort());
+    EXPECT_TRUE(first >= 0 && second >= 0);
+    EXPECT_EQ(Exchange(first, script), expected);
+    EXPECT_EQ(Exchange(second, "S\n"), std::string("e no game; start one with N\n"));
+    EXPECT_EQ(Exchange(second, "N 5 5 1 2\n"), std::string("p 2\n"));
+    // Replies past the server's output bound pause the pipeline until they are read, then it resumes
+    const std::string big = Exchange(second, "N 1000 1000 1000 1\nS\nS\nS\nR 1000 0\n");
+    EXPECT_EQ(big.size(), std::string("p 1\n").size() + 3 * (std::string("p 1000 1000 \n").size() + 1000000)
+        + std::string("e cell out of range\n").size());
+    EXPECT_EQ(Exchange(first, "Q\n"), std::string("bye\n"));
+    char byte;
+    EXPECT_EQ(read(first, &byte, 1), 0);
+    close(first);
+
+    // A recycled session does not show the previous client's game
+    const int third = ConnectLocal(server.getTcpPort());
+    EXPECT_EQ(Exchange(third, "S\n"), std::string("e no game; start one with N\n"));
+    close(second);
+    close(third);
+
+    server.stop();
+    loop.join();
+    EXPECT_EQ(server.getSessionCount(), static_cast<size_t>(0));
+    EXPECT_EQ(server.getCommandCount(), 13ull);
+}
+#endif
+
 int main() {
     std::cout << "Running simple tests...\n";
 
@@ -63,6 +1124,36 @@ int main() {
     TestToggleFlagAndCount();
     TestResetClearsFlags();
     TestChordNoCrash();
+    TestLargeOpeningReveal();
+    TestAdjacentCountsMatchMines();
+    TestSeededPlacementIsReproducible();
+    TestSafeZoneAroundFirstClick();
+    TestDenseBoardPlacement();
+    TestSolverDeductionsAreSound();
+    TestSolverReportsProvedCells();
+    TestProbabilitiesMatchBruteForce();
+    TestProbabilitiesSumToMines();
+    TestGenerateWithoutReveal();
+    TestChangedCellsPerAction();
+    TestChunkedBoardLayout();
+    TestChunkedBoardMineHitNeverWins();
+    TestChunkedBoardHuge();
+    TestInfiniteBoardEviction();
+    TestSnapshotRoundTrip();
+    TestActionLogReplay();
+    TestUndoRedo();
+    TestNoGuessGenerator();
+    TestPrefetchedReset();
+    TestBoardEvents();
+    TestFrontierIndex();
+    TestMineHitNeverWins();
+    TestBoardMetrics();
+    TestOpeningLabels();
+    TestGameProtocol();
+    TestSharedBoardStress();
+#ifdef __linux__
+    TestGameServer();
+#endif
 
     std::cout << "Tests run: " << g_tests << ", Failures: " << g_fails << "\n";
     if (g_fails == 0) {
@@ -0,0 +1,130 @@
+//Batch difficulty analysis: lays out many boards of one configuration and reports the spread of
+//3BV, openings and islands, for picking presets and normalizing times by difficulty. Usage:
+//  board_stats [--width W] [--height H] [--mines M] [--boards N] [--threads T] [--seed S] [--min-3bv A] [--max-3bv B]
+//Boards are numbered like simulate's games (same --seed, first click in the centre), so board i is game i.
+//With --min-3bv or --max-3bv the seed of every board inside the range is printed, one per line.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include "BoardAnalyzer.h"
+#include "Random.h"
+
+struct StatsConfig {
+	int width = 30;
+	int height = 16;
+	int mines = 99;
+	long long boards = 1000000;
+	int threads = 0;
+	uint64_t seed = 1;
+	int min3bv = 0;
+	int max3bv = INT_MAX;
+	bool filter = false;
+};
+
+static bool parseArgs(int argc, char** argv, StatsConfig& config)
+{
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const char* value = argv[i + 1];
+		if (!std::strcmp(argv[i], "--width")) config.width = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--height")) config.height = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--mines")) config.mines = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--boards")) config.boards = std::atoll(value);
+		else if (!std::strcmp(argv[i], "--threads")) config.threads = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--seed")) config.seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(argv[i], "--min-3bv")) config.min3bv = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--max-3bv")) config.max3bv = std::atoi(value);
+		else return false;
+		config.filter |= !std::strcmp(argv[i], "--min-3bv") || !std::strcmp(argv[i], "--max-3bv");
+	}
+	return argc % 2 == 1 && config.width > 0 && config.height > 0 && config.mines >= 0
+		&& config.mines < config.width * config.height && config.boards > 0;
+}
+
+//Running totals of one metric; the histogram gives exact percentiles without keeping every value
+struct Distribution {
+	std::vector<long long> counts;
+	long long total = 0;
+	double sum = 0.0;
+
+	void add(int value) {
+		if (value >= static_cast<int>(counts.size())) counts.resize(value + 1, 0);
+		++counts[value];
+		++total;
+		sum += value;
+	}
+	int percentile(double p) const {
+		long long rank = std::min(total - 1, static_cast<long long>(p * total));
+		for (size_t v = 0; v < counts.size(); ++v) {
+			if (rank < counts[v]) return static_cast<int>(v);
+			rank -= counts[v];
+		}
+		return static_cast<int>(counts.size()) - 1;
+	}
+};
+
+static void printDistribution(const char* name, const Distribution& d)
+{
+	std::cout << std::left << std::setw(12) << name << std::right << "mean=" << d.sum / d.total
+		<< " p10=" << d.percentile(0.10) << " p50=" << d.percentile(0.50) << " p90=" << d.percentile(0.90)
+		<< " min=" << d.percentile(0.0) << " max=" << d.percentile(1.0) << "\n";
+}
+
+int main(int argc, char** argv)
+{
+	StatsConfig config;
+	if (!parseArgs(argc, argv, config)) {
+		std::cerr << "usage: board_stats [--width W] [--height H] [--mines M] [--boards N] [--threads T] [--seed S] [--min-3bv A] [--max-3bv B]\n";
+		return 2;
+	}
+
+	BoardAnalyzer analyzer(config.threads);
+	Distribution bbbv, openings, isolated, islands;
+	std::vector<uint64_t> seeds;
+	std::vector<BoardMetrics> metrics;
+	long long matched = 0;
+
+	//Boards are scored in chunks so memory stays flat however many are requested
+	const long long chunk = 1 << 16;
+	const auto start = std::chrono::steady_clock::now();
+	for (long long first = 0; first < config.boards; first += chunk) {
+		const long long last = std::min(first + chunk, config.boards);
+		seeds.resize(static_cast<size_t>(last - first));
+		for (long long i = first; i < last; ++i) seeds[i - first] = gameSeed(config.seed, i);
+		analyzer.analyzeSeeds(config.width, config.height, config.mines, config.width / 2, config.height / 2, seeds, metrics);
+
+		for (size_t i = 0; i < metrics.size(); ++i) {
+			const BoardMetrics& m = metrics[i];
+			bbbv.add(m.bbbv);
+			openings.add(m.openings);
+			isolated.add(m.isolatedNumbers);
+			islands.add(m.islands);
+			if (config.filter && m.bbbv >= config.min3bv && m.bbbv <= config.max3bv) {
+				std::cout << seeds[i] << "\n";
+				++matched;
+			}
+		}
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	//In filter mode stdout holds only seeds, so the summary goes to stderr
+	std::ostream& out = config.filter ? std::cerr : std::cout;
+	out << std::fixed << std::setprecision(2);
+	out << "config      " << config.width << "x" << config.height << " mines=" << config.mines
+		<< " boards=" << config.boards << " seed=" << config.seed << "\n";
+	if (config.filter) {
+		out << "matched     " << matched << " (" << 100.0 * matched / config.boards << "%)\n";
+	} else {
+		printDistribution("3bv", bbbv);
+		printDistribution("openings", openings);
+		printDistribution("isolated", isolated);
+		printDistribution("islands", islands);
+	}
+	out << "throughput  " << config.boards / seconds << " boards/s (" << seconds << " s)\n";
+	return 0;
+}
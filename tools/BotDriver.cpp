@@ -0,0 +1,60 @@
+//Headless game driver for bots: speaks the GameProtocol line protocol on stdin/stdout. Usage:
+//  bot_driver < commands > replies
+//Input is read in large blocks and the replies to every complete command in a block go out in one write,
+//so a bot that pipelines commands pays one system call per block while an interactive bot still gets
+//each reply as soon as its command arrives.
+#include <string>
+#include <vector>
+#include <cstring>
+#include "GameProtocol.h"
+#ifdef _WIN32
+#include <io.h>
+#define read _read
+#define write _write
+#else
+#include <unistd.h>
+#endif
+
+static bool flush(std::string& out)
+{
+	size_t written = 0;
+	while (written < out.size()) {
+		const auto n = write(1, out.data() + written, static_cast<unsigned>(out.size() - written));
+		if (n <= 0) return false;
+		written += static_cast<size_t>(n);
+	}
+	out.clear();
+	return true;
+}
+
+int main()
+{
+	GameProtocol protocol;
+	std::vector<char> input(1 << 16);
+	size_t filled = 0;
+	std::string out;
+	out.reserve(1 << 16);
+
+	for (;;) {
+		const auto n = read(0, input.data() + filled, static_cast<unsigned>(input.size() - filled));
+		if (n <= 0) break;
+		filled += static_cast<size_t>(n);
+
+		size_t start = 0;
+		while (const char* newline = static_cast<const char*>(std::memchr(input.data() + start, '\n', filled - start))) {
+			protocol.execute(input.data() + start, static_cast<size_t>(newline - (input.data() + start)), out);
+			start = static_cast<size_t>(newline - input.data()) + 1;
+			if (protocol.isClosed()) return flush(out) ? 0 : 1;
+			if (out.size() >= (1 << 16) && !flush(out)) return 1;
+		}
+		//Keep the partial command for the next read; a line longer than the buffer grows it
+		std::memmove(input.data(), input.data() + start, filled - start);
+		filled -= start;
+		if (filled == input.size()) input.resize(input.size() * 2);
+		if (!flush(out)) return 1;
+	}
+
+	//A last command without a newline still counts
+	if (filled > 0) protocol.execute(input.data(), filled, out);
+	return flush(out) ? 0 : 1;
+}
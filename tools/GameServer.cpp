@@ -0,0 +1,65 @@
+//Multi-session game server: hosts GameProtocol sessions (see src/GameProtocol.h) over TCP and/or a Unix
+//socket until interrupted. Usage:
+//  game_server [--port P] [--host A] [--unix PATH] [--workers N]
+//Without --port or --unix it listens on 127.0.0.1:7878. Pair with load_client to measure it.
+#include <iostream>
+#include <string>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+#include "GameServer.h"
+
+static GameServer* running = nullptr;
+
+static void onSignal(int)
+{
+	if (running) running->stop();
+}
+
+int main(int argc, char** argv)
+{
+	int port = -1;
+	int workers = 0;
+	std::string host = "127.0.0.1";
+	std::string unixPath;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!std::strcmp(argv[i], "--port")) port = std::atoi(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--host")) host = argv[i + 1];
+		else if (!std::strcmp(argv[i], "--unix")) unixPath = argv[i + 1];
+		else if (!std::strcmp(argv[i], "--workers")) workers = std::atoi(argv[i + 1]);
+		else argc = 0;
+	}
+	if (argc % 2 == 0) {
+		std::cerr << "usage: game_server [--port P] [--host A] [--unix PATH] [--workers N]\n";
+		return 2;
+	}
+	if (port < 0 && unixPath.empty()) port = 7878;
+
+	//Every session is a descriptor, so allow as many as the system does
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	GameServer server(workers);
+	if (port >= 0 && !server.listenTcp(port, host)) {
+		std::cerr << "cannot listen on " << host << ":" << port << "\n";
+		return 1;
+	}
+	if (!unixPath.empty() && !server.listenUnix(unixPath)) {
+		std::cerr << "cannot listen on " << unixPath << "\n";
+		return 1;
+	}
+	if (port >= 0) std::cerr << "listening on " << host << ":" << server.getTcpPort() << "\n";
+	if (!unixPath.empty()) std::cerr << "listening on " << unixPath << "\n";
+
+	running = &server;
+	std::signal(SIGINT, onSignal);
+	std::signal(SIGTERM, onSignal);
+	server.run();
+	running = nullptr;
+	std::cerr << server.getCommandCount() << " commands served\n";
+	return 0;
+}
@@ -0,0 +1,228 @@
+//Load generator for game_server: opens many sessions and has each play random games, then reports
+//commands per second and round-trip latency percentiles. Usage:
+//  load_client [--port P] [--host A] [--unix PATH] [--sessions N] [--seconds S] [--threads T] [--width W] [--height H] [--mines M]
+//Each session keeps exactly one command in flight, so a latency sample is the full round trip of one command.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "Random.h"
+#include "ThreadPool.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct LoadConfig {
+	int port = 7878;
+	std::string host = "127.0.0.1";
+	std::string unixPath;
+	int sessions = 1000;
+	double seconds = 5.0;
+	int threads = 1;
+	int width = 30;
+	int height = 16;
+	int mines = 99;
+};
+
+struct Client {
+	int fd = -1;
+	std::string reply; //Reply received so far
+	Clock::time_point sentAt;
+	uint64_t seed = 0;
+	bool needGame = true; //The last game ended, so the next command is N
+};
+
+//What one thread measured
+struct LoadStats {
+	std::vector<uint32_t> latencyNs;
+	long long games = 0;
+	long long won = 0;
+	long long errors = 0;
+};
+
+static bool parseArgs(int argc, char** argv, LoadConfig& config)
+{
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const char* value = argv[i + 1];
+		if (!std::strcmp(argv[i], "--port")) config.port = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--host")) config.host = value;
+		else if (!std::strcmp(argv[i], "--unix")) config.unixPath = value;
+		else if (!std::strcmp(argv[i], "--sessions")) config.sessions = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--seconds")) config.seconds = std::atof(value);
+		else if (!std::strcmp(argv[i], "--threads")) config.threads = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--width")) config.width = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--height")) config.height = std::atoi(value);
+		else if (!std::strcmp(argv[i], "--mines")) config.mines = std::atoi(value);
+		else return false;
+	}
+	return argc % 2 == 1 && config.sessions > 0 && config.seconds > 0.0 && config.threads > 0
+		&& config.width > 0 && config.height > 0 && config.mines >= 0 && config.mines < config.width * config.height;
+}
+
+static int connectTo(const LoadConfig& config)
+{
+	if (!config.unixPath.empty()) {
+		sockaddr_un address;
+		std::memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		std::strncpy(address.sun_path, config.unixPath.c_str(), sizeof(address.sun_path) - 1);
+		const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) return fd;
+		if (fd >= 0) close(fd);
+		return -1;
+	}
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(static_cast<uint16_t>(config.port));
+	if (inet_pton(AF_INET, config.host.c_str(), &address.sin_addr) != 1) return -1;
+	const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) {
+		const int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		return fd;
+	}
+	if (fd >= 0) close(fd);
+	return -1;
+}
+
+//Starts a new game when the last one ended, otherwise reveals a random cell
+static bool sendNext(Client& client, const LoadConfig& config, Random& rng)
+{
+	char command[64];
+	int length;
+	if (client.needGame) {
+		length = std::snprintf(command, sizeof(command), "N %d %d %d %llu\n", config.width, config.height, config.mines,
+			static_cast<unsigned long long>(client.seed++));
+	} else {
+		length = std::snprintf(command, sizeof(command), "R %u %u\n", rng.below(static_cast<uint32_t>(config.width)),
+			rng.below(static_cast<uint32_t>(config.height)));
+	}
+	client.sentAt = Clock::now();
+	return send(client.fd, command, static_cast<size_t>(length), MSG_NOSIGNAL) == length;
+}
+
+static bool runThread(const LoadConfig& config, int thread, LoadStats& stats)
+{
+	std::vector<Client> clients;
+	for (int i = thread; i < config.sessions; i += config.threads) clients.emplace_back();
+	const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+	Random rng(hashSeed(0x5EED, static_cast<uint64_t>(thread), 0));
+	bool ok = epollFd >= 0;
+	for (size_t i = 0; ok && i < clients.size(); ++i) {
+		Client& client = clients[i];
+		client.fd = connectTo(config);
+		client.seed = hashSeed(1, static_cast<uint64_t>(thread), i) & 0xFFFFFFFF;
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.ptr = &client;
+		ok = client.fd >= 0 && epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event) == 0;
+	}
+
+	const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.seconds));
+	for (size_t i = 0; ok && i < clients.size(); ++i) ok = sendNext(clients[i], config, rng);
+
+	epoll_event events[256];
+	char buffer[65536];
+	while (ok && Clock::now() < end) {
+		const int ready = epoll_wait(epollFd, events, 256, 100);
+		for (int i = 0; ok && i < ready; ++i) {
+			Client& client = *static_cast<Client*>(events[i].data.ptr);
+			const ssize_t n = read(client.fd, buffer, sizeof(buffer));
+			if (n <= 0) {
+				ok = false;
+				break;
+			}
+			const size_t scanFrom = client.reply.size();
+			client.reply.append(buffer, static_cast<size_t>(n));
+			if (client.reply.find('\n', scanFrom) == std::string::npos) continue;
+
+			const Clock::time_point now = Clock::now();
+			const long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - client.sentAt).count();
+			stats.latencyNs.push_back(static_cast<uint32_t>(std::min<long long>(ns, UINT32_MAX)));
+			const char status = client.reply[0];
+			if (status == 'e') ++stats.errors;
+			if (client.needGame) ++stats.games;
+			if (status == 'w') ++stats.won;
+			client.needGame = status != 'p';
+			client.reply.clear();
+			if (now < end) ok = sendNext(client, config, rng);
+		}
+	}
+
+	for (Client& client : clients) {
+		if (client.fd >= 0) close(client.fd);
+	}
+	if (epollFd >= 0) close(epollFd);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	LoadConfig config;
+	if (!parseArgs(argc, argv, config)) {
+		std::cerr << "usage: load_client [--port P] [--host A] [--unix PATH] [--sessions N] [--seconds S] [--threads T]"
+			" [--width W] [--height H] [--mines M]\n";
+		return 2;
+	}
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	ThreadPool pool(config.threads);
+	std::vector<LoadStats> stats(static_cast<size_t>(config.threads));
+	std::atomic<int> failed(0);
+	const auto start = Clock::now();
+	pool.parallelFor(config.threads, [&](int thread) {
+		if (!runThread(config, thread, stats[static_cast<size_t>(thread)])) failed.fetch_add(1);
+	});
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	if (failed.load() > 0) {
+		std::cerr << "lost the connection to the server (is game_server running?)\n";
+		return 1;
+	}
+
+	LoadStats total;
+	for (LoadStats& s : stats) {
+		total.latencyNs.insert(total.latencyNs.end(), s.latencyNs.begin(), s.latencyNs.end());
+		total.games += s.games;
+		total.won += s.won;
+		total.errors += s.errors;
+	}
+	std::vector<uint32_t>& latency = total.latencyNs;
+	if (latency.empty()) {
+		std::cerr << "no replies received\n";
+		return 1;
+	}
+	auto percentile = [&latency](double p) {
+		const size_t k = std::min(latency.size() - 1, static_cast<size_t>(p * static_cast<double>(latency.size())));
+		std::nth_element(latency.begin(), latency.begin() + static_cast<std::ptrdiff_t>(k), latency.end());
+		return latency[k] / 1000.0;
+	};
+	std::cout << std::fixed << std::setprecision(1)
+		<< "sessions   " << config.sessions << "\n"
+		<< "commands   " << latency.size() << "\n"
+		<< "games      " << total.games << " (" << total.won << " won)\n"
+		<< "errors     " << total.errors << "\n"
+		<< "throughput " << std::setprecision(0) << latency.size() / seconds << " commands/s\n" << std::setprecision(1)
+		<< "p50        " << percentile(0.50) << " us\n"
+		<< "p99        " << percentile(0.99) << " us\n"
+		<< "max        " << *std::max_element(latency.begin(), latency.end()) / 1000.0 << " us\n";
+	return 0;
+}
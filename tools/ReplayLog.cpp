@@ -0,0 +1,61 @@
+//Headless replay of recorded games: fast-forwards each action log without drawing and prints the final
+//state, so runs before and after an engine change can be diffed. Usage:
+//  replay_log [--seek N] [--repeat R] game.mlog...
+//--seek stops after N actions; --repeat replays each log R times (seeking back through keyframes) for timing.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "Board.h"
+#include "ActionLog.h"
+#include "Replay.h"
+
+int main(int argc, char** argv)
+{
+	size_t seekTo = SIZE_MAX;
+	int repeat = 1;
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--seek") && i + 1 < argc) seekTo = std::strtoull(argv[++i], nullptr, 10);
+		else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+		else files.push_back(argv[i]);
+	}
+	if (files.empty()) {
+		std::cerr << "usage: replay_log [--seek N] [--repeat R] game.mlog...\n";
+		return 2;
+	}
+
+	long long applied = 0;
+	double seconds = 0.0;
+	int failed = 0;
+	ActionLog log;
+	for (const std::string& file : files) {
+		if (!log.load(file)) {
+			std::cerr << file << ": not a valid action log\n";
+			++failed;
+			continue;
+		}
+		Board board(log.getWidth(), log.getHeight(), log.getMineCount(), log.getSeed());
+		Replay replay(log, board);
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < repeat; ++r) {
+			if (r > 0) replay.seek(0);
+			replay.seek(seekTo);
+			applied += static_cast<long long>(replay.getPosition());
+		}
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << file << " " << board.getWidth() << "x" << board.getHeight() << " seed=" << board.getSeed()
+			<< " actions=" << replay.getPosition() << "/" << replay.size() << " time=" << replay.getTimeMs() << "ms"
+			<< " revealed=" << board.getCellsRevealed() << " flags=" << board.getFlagsPlaced()
+			<< " result=" << (board.getIsGameWon() ? "won" : board.getIsGameOver() ? "lost" : "open") << "\n";
+	}
+	if (seconds > 0.0) {
+		std::cerr << std::fixed << std::setprecision(0) << applied / seconds << " actions/s (" << applied << " actions)\n";
+	}
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+//Headless batch simulator: plays many games of one configuration across all cores and reports
+//win rate, guesses and throughput. Usage:
+//  simulate [--width W] [--height H] [--mines M] [--games N] [--threads T] [--seed S] [--record DIR] [--no-guess]
+//--record writes every game's action log to DIR/game_<n>.mlog for replay_log
+//--no-guess plays only layouts that NoGuessGenerator accepted for the centre click
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "Board.h"
+#include "Solver.h"
+#include "ProbabilityEngine.h"
+#include "ActionLog.h"
+#include "NoGuessGenerator.h"
+#include "Random.h"
+
+struct SimConfig {
+	int width = 30;
+	int height = 16;
+	int mines = 99;
+	long long games = 100000;
+	int threads = 0;
+	uint64_t seed = 1;
+	std::string record;
+	bool noGuess = false;
+};
+
+//Per-thread totals; merged once all workers have finished
+struct WorkerStats {
+	long long wins = 0;
+	long long losses = 0;
+	long long guesses = 0;
+	long long noGuessWins = 0;
+	long long candidates = 0; //Layouts solved by the no-guess generator
+	std::vector<uint32_t> latencyNs;
+};
+
+//Plays one game: deterministic moves first, then the lowest-probability guess whenever the solver is stuck
+static int playGame(Board& board, Solver& solver, ProbabilityEngine& engine, std::vector<double>& probabilities)
+{
+	int guesses = 0;
+	solver.reset();
+	while (!solver.solve() && !board.getIsGameOver()) {
+		engine.compute(board, probabilities);
+		int best = -1;
+		for (int i = 0; i < static_cast<int>(probabilities.size()); ++i) {
+			Cell c = board.getCell(i % board.getWidth(), i / board.getWidth());
+			if (c.isRevealed || c.isFlagged || solver.isKnownMine(i % board.getWidth(), i / board.getWidth())) continue;
+			if (best < 0 || probabilities[i] < probabilities[best]) best = i;
+		}
+		if (best < 0) break;
+		++guesses;
+		solver.reveal(best % board.getWidth(), best / board.getWidth());
+	}
+	return guesses;
+}
+
+static bool parseArgs(int argc, char** argv, SimConfig& config)
+{
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--no-guess")) {
+			config.noGuess = true;
+			continue;
+		}
+		if (i + 1 >= argc) return false;
+		const char* value = argv[++i];
+		if (!std::strcmp(argv[i - 1], "--width")) config.width = std::atoi(value);
+		else if (!std::strcmp(argv[i - 1], "--height")) config.height = std::atoi(value);
+		else if (!std::strcmp(argv[i - 1], "--mines")) config.mines = std::atoi(value);
+		else if (!std::strcmp(argv[i - 1], "--games")) config.games = std::atoll(value);
+		else if (!std::strcmp(argv[i - 1], "--threads")) config.threads = std::atoi(value);
+		else if (!std::strcmp(argv[i - 1], "--seed")) config.seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(argv[i - 1], "--record")) config.record = value;
+		else return false;
+	}
+	return config.width > 0 && config.height > 0 && config.mines >= 0 && config.mines < config.width * config.height && config.games > 0;
+}
+
+int main(int argc, char** argv)
+{
+	SimConfig config;
+	if (!parseArgs(argc, argv, config)) {
+		std::cerr << "usage: simulate [--width W] [--height H] [--mines M] [--games N] [--threads T] [--seed S] [--record DIR] [--no-guess]\n";
+		return 2;
+	}
+	int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+	if (threads <= 0) threads = 1;
+
+	//Games are handed out in small batches from a shared counter, so fast threads keep taking work
+	const long long batchSize = 64;
+	std::atomic<long long> nextBatch(0);
+	std::vector<WorkerStats> stats(threads);
+
+	auto worker = [&](int id) {
+		WorkerStats& mine = stats[id];
+		Board board(config.width, config.height, config.mines, 0);
+		Solver solver(board);
+		ProbabilityEngine engine(1);
+		std::vector<double> probabilities;
+		ActionLog log;
+		if (!config.record.empty()) board.setRecorder(&log);
+		NoGuessGenerator generator(1); //Games already run one per thread
+		for (;;) {
+			long long first = nextBatch.fetch_add(1) * batchSize;
+			if (first >= config.games) break;
+			long long last = std::min(first + batchSize, config.games);
+			for (long long game = first; game < last; ++game) {
+				auto start = std::chrono::steady_clock::now();
+				uint64_t seed = gameSeed(config.seed, game);
+				if (config.noGuess && generator.findSeed(config.width, config.height, config.mines, config.width / 2, config.height / 2, seed, seed)) {
+					mine.candidates += generator.getAttempts();
+				}
+				board.resetBoard(seed);
+				int guesses = playGame(board, solver, engine, probabilities);
+				auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+				if (!config.record.empty()) log.save(config.record + "/game_" + std::to_string(game) + ".mlog");
+
+				mine.latencyNs.push_back(static_cast<uint32_t>(std::min<long long>(elapsed, UINT32_MAX)));
+				mine.guesses += guesses;
+				if (board.getIsGameWon()) {
+					++mine.wins;
+					if (guesses == 0) ++mine.noGuessWins;
+				} else {
+					++mine.losses;
+				}
+			}
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (int i = 1; i < threads; ++i) pool.emplace_back(worker, i);
+	worker(0);
+	for (std::thread& t : pool) t.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	WorkerStats total;
+	for (WorkerStats& s : stats) {
+		total.wins += s.wins;
+		total.losses += s.losses;
+		total.guesses += s.guesses;
+		total.noGuessWins += s.noGuessWins;
+		total.candidates += s.candidates;
+		total.latencyNs.insert(total.latencyNs.end(), s.latencyNs.begin(), s.latencyNs.end());
+	}
+	std::vector<uint32_t>& latency = total.latencyNs;
+	auto percentile = [&](double p) {
+		size_t k = std::min(latency.size() - 1, static_cast<size_t>(p * latency.size()));
+		std::nth_element(latency.begin(), latency.begin() + k, latency.end());
+		return latency[k] / 1000.0;
+	};
+
+	const double games = static_cast<double>(config.games);
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "config      " << config.width << "x" << config.height << " mines=" << config.mines
+		<< " games=" << config.games << " threads=" << threads << " seed=" << config.seed << "\n";
+	std::cout << "wins        " << total.wins << " (" << 100.0 * total.wins / games << "%)\n";
+	std::cout << "losses      " << total.losses << "\n";
+	std::cout << "no-guess    " << total.noGuessWins << " (" << 100.0 * total.noGuessWins / games << "%)\n";
+	std::cout << "guesses     " << total.guesses << " (" << total.guesses / games << " per game)\n";
+	if (config.noGuess) std::cout << "candidates  " << total.candidates / games << " layouts solved per game\n";
+	std::cout << "throughput  " << games / seconds << " games/s (" << seconds << " s)\n";
+	std::cout << "latency us  p50=" << percentile(0.50) << " p90=" << percentile(0.90)
+		<< " p99=" << percentile(0.99) << " max=" << percentile(1.0) << "\n";
+	return 0;
+}